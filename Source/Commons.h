@@ -37,3 +37,26 @@
 #else
   #define ONLY_ON_DEBUG(X)
 #endif
+
+/** Set this to 1 to use the fast approximation of the sine LFO shape
+    by default (see HyperTremoloEngine::setFastMath)
+*/
+#ifndef HYPERTREMOLO_FAST_MATH
+  #define HYPERTREMOLO_FAST_MATH 0
+#endif
+
+/** Set this to 0 to evaluate the sine LFO shape on every sample by default,
+    instead of at control rate (see HyperTremoloEngine::setControlRate)
+*/
+#ifndef HYPERTREMOLO_CONTROL_RATE
+  #define HYPERTREMOLO_CONTROL_RATE 1
+#endif
+
+/** Set this to 1 to measure the time spent in the audio callback and
+    in prepareToPlay. The statistics are written to the log every 1000
+    callbacks (from the audio thread: only use this for profiling builds)
+    and every 10 calls to prepareToPlay.
+*/
+#ifndef HYPERTREMOLO_PROFILE
+  #define HYPERTREMOLO_PROFILE 0
+#endif
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    Chunking.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Maximum number of samples the DSP widgets process at once.
+
+    Blocks of any size are split into chunks of at most this size, so that
+    scratch buffers never need to be larger than this, whatever the block
+    size announced by the host.
+*/
+static constexpr size_t dspChunkSize = 128;
+
+/** Gets a copy of a ProcessSpec with the block size set to the chunk size.
+
+    The announced block size is ignored: hosts may send larger blocks than
+    they announce, and the chunks are always up to dspChunkSize long.
+*/
+inline juce::dsp::ProcessSpec chunkedSpec (const juce::dsp::ProcessSpec& spec)
+{
+    return { spec.sampleRate, (juce::uint32) dspChunkSize, spec.numChannels };
+}
+
+/** Checks whether two specs describe the same processing setup */
+inline bool isSameSpec (const juce::dsp::ProcessSpec& a, const juce::dsp::ProcessSpec& b) noexcept
+{
+    return a.sampleRate == b.sampleRate
+           && a.maximumBlockSize == b.maximumBlockSize
+           && a.numChannels == b.numChannels;
+}
+
+/** Calls a process function on the samples of a replacing context
+    from start, of the given length
+*/
+template <typename SampleType, typename ProcessFunction>
+void processSubContext (const juce::dsp::ProcessContextReplacing<SampleType>& context,
+                        size_t start,
+                        size_t length,
+                        ProcessFunction&& processFunction) noexcept
+{
+    auto block = context.getOutputBlock().getSubBlock (start, length);
+    juce::dsp::ProcessContextReplacing<SampleType> subContext (block);
+    subContext.isBypassed = context.isBypassed;
+    processFunction (subContext);
+}
+
+/** Calls a process function on the samples of a non-replacing context
+    from start, of the given length
+*/
+template <typename SampleType, typename ProcessFunction>
+void processSubContext (const juce::dsp::ProcessContextNonReplacing<SampleType>& context,
+                        size_t start,
+                        size_t length,
+                        ProcessFunction&& processFunction) noexcept
+{
+    const auto inputBlock = context.getInputBlock().getSubBlock (start, length);
+    auto outputBlock = context.getOutputBlock().getSubBlock (start, length);
+    juce::dsp::ProcessContextNonReplacing<SampleType> subContext (inputBlock, outputBlock);
+    subContext.isBypassed = context.isBypassed;
+    processFunction (subContext);
+}
+
+/** Calls a process function on consecutive chunks of a context */
+template <typename ProcessContext, typename ProcessFunction>
+void forEachChunk (const ProcessContext& context,
+                   size_t chunkSize,
+                   ProcessFunction&& processFunction) noexcept
+{
+    const auto numSamples = context.getOutputBlock().getNumSamples();
+
+    for (size_t start = 0; start < numSamples; start += chunkSize)
+        processSubContext (context, start, juce::jmin (chunkSize, numSamples - start), processFunction);
+}
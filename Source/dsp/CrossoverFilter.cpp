@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    CrossoverFilter.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "CrossoverFilter.h"
+
+//==============================================================================
+template <typename SampleType>
+CrossoverFilter<SampleType>::CrossoverFilter()
+    : cutoffFrequency (1000.0), resonance (1.0 / juce::MathConstants<double>::sqrt2)
+{
+    update();
+}
+
+//==============================================================================
+template <typename SampleType>
+void CrossoverFilter<SampleType>::setCutoffFrequency (SampleType newCutoffFrequencyHz)
+{
+    jassert (juce::isPositiveAndBelow (newCutoffFrequencyHz, static_cast<SampleType> (sampleRate * 0.5)));
+    cutoffFrequency.setTargetValue (newCutoffFrequencyHz);
+    if (! cutoffFrequency.isSmoothing())
+        update();
+}
+
+template <typename SampleType>
+void CrossoverFilter<SampleType>::setResonance (SampleType newResonance)
+{
+    jassert (newResonance > static_cast<SampleType> (0));
+    resonance.setTargetValue (newResonance);
+    if (! resonance.isSmoothing())
+        update();
+}
+
+//==============================================================================
+template <typename SampleType>
+void CrossoverFilter<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+    jassert (spec.numChannels > 0);
+
+    sampleRate = spec.sampleRate;
+    cutoffFrequency.reset (sampleRate, 0.050);
+    resonance.reset (sampleRate, 0.050);
+
+    const auto numGroups = (spec.numChannels + lanes - 1) / lanes;
+    s1.resize (numGroups);
+    s2.resize (numGroups);
+
+    lowPassScratch.resize (spec.maximumBlockSize);
+    highPassScratch.resize (spec.maximumBlockSize);
+
+    reset();
+    update();
+}
+
+template <typename SampleType>
+void CrossoverFilter<SampleType>::reset()
+{
+    cutoffFrequency.setCurrentAndTargetValue (cutoffFrequency.getTargetValue());
+    resonance.setCurrentAndTargetValue (resonance.getTargetValue());
+    update();
+
+    std::fill (s1.begin(), s1.end(), Vector::expand (0));
+    std::fill (s2.begin(), s2.end(), Vector::expand (0));
+}
+
+//==============================================================================
+template <typename SampleType>
+void CrossoverFilter<SampleType>::process (const juce::dsp::AudioBlock<const SampleType>& inputBlock,
+                                           const juce::dsp::AudioBlock<SampleType>& lowPassBlock,
+                                           const juce::dsp::AudioBlock<SampleType>& highPassBlock) noexcept
+{
+    if (! cutoffFrequency.isSmoothing() && ! resonance.isSmoothing())
+    {
+        processSegment (inputBlock, lowPassBlock, highPassBlock);
+        return;
+    }
+
+    // While gliding, the coefficients are updated every few samples
+    const auto numSamples = inputBlock.getNumSamples();
+    for (size_t start = 0; start < numSamples; start += smoothingInterval)
+    {
+        const auto length = juce::jmin (smoothingInterval, numSamples - start);
+        cutoffFrequency.skip ((int) length);
+        resonance.skip ((int) length);
+        update();
+
+        processSegment (inputBlock.getSubBlock (start, length),
+                        lowPassBlock.getSubBlock (start, length),
+                        highPassBlock.getSubBlock (start, length));
+    }
+}
+
+template <typename SampleType>
+void CrossoverFilter<SampleType>::processSegment (const juce::dsp::AudioBlock<const SampleType>& inputBlock,
+                                                  const juce::dsp::AudioBlock<SampleType>& lowPassBlock,
+                                                  const juce::dsp::AudioBlock<SampleType>& highPassBlock) noexcept
+{
+    const auto numChannels = inputBlock.getNumChannels();
+    const auto numSamples = inputBlock.getNumSamples();
+
+    jassert (lowPassBlock.getNumChannels() == numChannels);
+    jassert (highPassBlock.getNumChannels() == numChannels);
+    jassert (lowPassBlock.getNumSamples() == numSamples);
+    jassert (highPassBlock.getNumSamples() == numSamples);
+    jassert (numChannels <= s1.size() * lanes);
+
+    size_t group = 0, first = 0;
+    for (; first + lanes <= numChannels; ++group, first += lanes)
+    {
+        // Blocks longer than the prepared size go through the scratch in parts
+        jassert (numSamples <= lowPassScratch.size());
+        const auto scratchSize = juce::jmax ((size_t) 1, lowPassScratch.size());
+        for (size_t start = 0; start < numSamples; start += scratchSize)
+        {
+            const auto length = juce::jmin (scratchSize, numSamples - start);
+            processGroup (group, first,
+                          inputBlock.getSubBlock (start, length),
+                          lowPassBlock.getSubBlock (start, length),
+                          highPassBlock.getSubBlock (start, length));
+        }
+    }
+
+    if (first < numChannels)
+        processRemainder (group, first, inputBlock, lowPassBlock, highPassBlock);
+}
+
+template <typename SampleType>
+void CrossoverFilter<SampleType>::processGroup (size_t group, size_t first,
+                                                const juce::dsp::AudioBlock<const SampleType>& inputBlock,
+                                                const juce::dsp::AudioBlock<SampleType>& lowPassBlock,
+                                                const juce::dsp::AudioBlock<SampleType>& highPassBlock) noexcept
+{
+    const auto numSamples = inputBlock.getNumSamples();
+    jassert (numSamples <= lowPassScratch.size());
+
+    // The scratch is accessed as raw samples: lane k of sample i is at i * lanes + k
+    auto* lowPass = reinterpret_cast<SampleType*> (lowPassScratch.data());
+    auto* highPass = reinterpret_cast<SampleType*> (highPassScratch.data());
+
+    // The input is interleaved into the low-pass scratch, which is
+    // overwritten sample by sample
+    for (size_t k = 0; k < lanes; ++k)
+    {
+        const auto* input = inputBlock.getChannelPointer (first + k);
+        for (size_t i = 0; i < numSamples; ++i)
+            lowPass[i * lanes + k] = input[i];
+    }
+
+    const auto vg = Vector::expand (g);
+    const auto vh = Vector::expand (h);
+    const auto vgR2 = Vector::expand (g + R2);
+
+    auto vs1 = s1[group];
+    auto vs2 = s2[group];
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        const auto x = Vector::fromRawArray (lowPass + i * lanes);
+
+        const auto yHP = vh * (x - vs1 * vgR2 - vs2);
+        const auto yBP = yHP * vg + vs1;
+        vs1 = yHP * vg + yBP;
+        const auto yLP = yBP * vg + vs2;
+        vs2 = yBP * vg + yLP;
+
+        yLP.copyToRawArray (lowPass + i * lanes);
+        yHP.copyToRawArray (highPass + i * lanes);
+    }
+    s1[group] = vs1;
+    s2[group] = vs2;
+
+    // The high-pass block can be the input: it is only written after the recursion
+    for (size_t k = 0; k < lanes; ++k)
+    {
+        auto* lowPassOut = lowPassBlock.getChannelPointer (first + k);
+        auto* highPassOut = highPassBlock.getChannelPointer (first + k);
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            lowPassOut[i] = lowPass[i * lanes + k];
+            highPassOut[i] = highPass[i * lanes + k];
+        }
+    }
+}
+
+template <typename SampleType>
+void CrossoverFilter<SampleType>::processRemainder (size_t group, size_t first,
+                                                    const juce::dsp::AudioBlock<const SampleType>& inputBlock,
+                                                    const juce::dsp::AudioBlock<SampleType>& lowPassBlock,
+                                                    const juce::dsp::AudioBlock<SampleType>& highPassBlock) noexcept
+{
+    const auto n = inputBlock.getNumChannels() - first;
+    const auto numSamples = inputBlock.getNumSamples();
+    jassert (n < lanes);
+
+    const SampleType* input[lanes];
+    SampleType* lowPass[lanes];
+    SampleType* highPass[lanes];
+    SampleType ss1[lanes], ss2[lanes];
+    for (size_t k = 0; k < n; ++k)
+    {
+        input[k] = inputBlock.getChannelPointer (first + k);
+        lowPass[k] = lowPassBlock.getChannelPointer (first + k);
+        highPass[k] = highPassBlock.getChannelPointer (first + k);
+        ss1[k] = s1[group].get (k);
+        ss2[k] = s2[group].get (k);
+    }
+
+    const auto gR2 = g + R2;
+
+    // The channels are independent: filtering them in the same loop
+    // overlaps their recursions
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        for (size_t k = 0; k < n; ++k)
+        {
+            const auto yHP = h * (input[k][i] - ss1[k] * gR2 - ss2[k]);
+            const auto yBP = yHP * g + ss1[k];
+            ss1[k] = yHP * g + yBP;
+            const auto yLP = yBP * g + ss2[k];
+            ss2[k] = yBP * g + yLP;
+
+            lowPass[k][i] = yLP;
+            highPass[k][i] = yHP;
+        }
+    }
+
+    for (size_t k = 0; k < n; ++k)
+    {
+        s1[group].set (k, ss1[k]);
+        s2[group].set (k, ss2[k]);
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void CrossoverFilter<SampleType>::update()
+{
+    g = static_cast<SampleType> (std::tan (juce::MathConstants<double>::pi * cutoffFrequency.getCurrentValue() / sampleRate));
+    R2 = static_cast<SampleType> (1.0 / resonance.getCurrentValue());
+    h = static_cast<SampleType> (1.0 / (1.0 + R2 * g + g * g));
+}
+
+//==============================================================================
+template <typename SampleType>
+constexpr size_t CrossoverFilter<SampleType>::smoothingInterval;
+
+//==============================================================================
+template class CrossoverFilter<float>;
+template class CrossoverFilter<double>;
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    CrossoverFilter.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    A state variable TPT filter which outputs both the low-pass and the
+    high-pass signal in a single pass.
+
+    The filter state is laid out in SIMD registers: each register holds a
+    group of channels (4 float or 2 double channels with 128-bit registers),
+    so that multichannel layouts are filtered one group at a time. A group
+    is interleaved once per block into aligned scratch, filtered register
+    by register and deinterleaved. The channels left over by the full
+    groups (e.g. both channels of a stereo float signal) are filtered
+    side by side with scalars, instead of in a partly empty register.
+
+    The filter equations are the same of juce::dsp::StateVariableTPTFilter.
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class CrossoverFilter
+{
+public:
+    //==============================================================================
+    using Vector = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr size_t lanes = Vector::SIMDNumElements;
+
+    //==============================================================================
+    /** Constructor. */
+    CrossoverFilter();
+
+    //==============================================================================
+    /** Sets the cutoff frequency (in Hz) of the filter.
+        Once prepared, the filter glides to the new frequency.
+    */
+    void setCutoffFrequency (SampleType newCutoffFrequencyHz);
+
+    /** Sets the resonance of the filter.
+        Once prepared, the filter glides to the new resonance.
+    */
+    void setResonance (SampleType newResonance);
+
+    //==============================================================================
+    /** Initialises the filter. */
+    void prepare (const juce::dsp::ProcessSpec&);
+
+    /** Resets the internal state variables of the filter.
+        The cutoff frequency and the resonance jump to their targets.
+    */
+    void reset();
+
+    //==============================================================================
+    /** Filters the input block into a low-pass and a high-pass block.
+        The high-pass block can be the same as the input block.
+    */
+    void process (const juce::dsp::AudioBlock<const SampleType>& inputBlock,
+                  const juce::dsp::AudioBlock<SampleType>& lowPassBlock,
+                  const juce::dsp::AudioBlock<SampleType>& highPassBlock) noexcept;
+
+private:
+    //==============================================================================
+    /** Filters a segment with the current coefficients */
+    void processSegment (const juce::dsp::AudioBlock<const SampleType>& inputBlock,
+                         const juce::dsp::AudioBlock<SampleType>& lowPassBlock,
+                         const juce::dsp::AudioBlock<SampleType>& highPassBlock) noexcept;
+
+    /** Filters a full group of channels, through the interleaved scratch */
+    void processGroup (size_t group, size_t first,
+                       const juce::dsp::AudioBlock<const SampleType>& inputBlock,
+                       const juce::dsp::AudioBlock<SampleType>& lowPassBlock,
+                       const juce::dsp::AudioBlock<SampleType>& highPassBlock) noexcept;
+
+    /** Filters the channels that do not fill a group, with scalars */
+    void processRemainder (size_t group, size_t first,
+                           const juce::dsp::AudioBlock<const SampleType>& inputBlock,
+                           const juce::dsp::AudioBlock<SampleType>& lowPassBlock,
+                           const juce::dsp::AudioBlock<SampleType>& highPassBlock) noexcept;
+
+    /** Updates the filter coefficients */
+    void update();
+
+    //==============================================================================
+    /** Number of samples between coefficient updates, while gliding */
+    static constexpr size_t smoothingInterval = 16;
+
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Multiplicative> cutoffFrequency, resonance;
+    SampleType g, h, R2;
+    double sampleRate = 44100.0;
+
+    // One register of state per group of channels (the lanes of the last
+    // one hold the state of the remaining channels)
+    std::vector<Vector> s1, s2;
+
+    // Interleaved samples of a group, one register per sample: the input
+    // and then the low-pass output, and the high-pass output
+    std::vector<Vector> lowPassScratch, highPassScratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CrossoverFilter<SampleType>)
+};
@@ -33,8 +33,6 @@ CrossoverWithBuffer<SampleType>::CrossoverWithBuffer()
     : process_lpf ([] (juce::dsp::ProcessContextReplacing<SampleType>) {}),
       process_hpf ([] (juce::dsp::ProcessContextReplacing<SampleType>) {})
 {
-    lpf.setType (juce::dsp::StateVariableTPTFilterType::lowpass);
-    hpf.setType (juce::dsp::StateVariableTPTFilterType::highpass);
     balance.setMixingRule (juce::dsp::DryWetMixingRule::sin3dB);
     balance.setWetMixProportion (0.5);
 }
@@ -43,21 +41,20 @@ CrossoverWithBuffer<SampleType>::CrossoverWithBuffer()
 template <typename SampleType>
 void CrossoverWithBuffer<SampleType>::setCutOffFrequency (SampleType newCutOffFrequency)
 {
-    lpf.setCutoffFrequency (newCutOffFrequency);
-    hpf.setCutoffFrequency (newCutOffFrequency);
+    filter.setCutoffFrequency (newCutOffFrequency);
 }
 
 template <typename SampleType>
 void CrossoverWithBuffer<SampleType>::setResonance (SampleType newResonance)
 {
-    lpf.setResonance (newResonance);
-    hpf.setResonance (newResonance);
+    filter.setResonance (newResonance);
 }
 
 template <typename SampleType>
 void CrossoverWithBuffer<SampleType>::setMix (SampleType newMix)
 {
-    dryWet.setWetMixProportion (newMix);
+    lpfDryWet.setWetMixProportion (newMix);
+    hpfDryWet.setWetMixProportion (newMix);
 }
 
 template <typename SampleType>
@@ -66,6 +63,12 @@ void CrossoverWithBuffer<SampleType>::setBalance (SampleType newBalance)
     balance.setWetMixProportion (newBalance);
 }
 
+template <typename SampleType>
+void CrossoverWithBuffer<SampleType>::setTap (CrossoverTap<SampleType>* newTap) noexcept
+{
+    tap.store (newTap, std::memory_order_release);
+}
+
 template <typename SampleType>
 void CrossoverWithBuffer<SampleType>::setLPFProcess (std::function<void (juce::dsp::ProcessContextReplacing<SampleType>)> f)
 {
@@ -82,23 +85,38 @@ void CrossoverWithBuffer<SampleType>::setHPFProcess (std::function<void (juce::d
 template <typename SampleType>
 void CrossoverWithBuffer<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
 {
-    sampleRate = spec.sampleRate;
-    dryWet.prepare (spec);
-    balance.prepare (spec);
-    lpf.prepare (spec);
-    hpf.prepare (spec);
-    lpfBuffer.reset (
-        new juce::AudioBuffer<SampleType> (
-            spec.numChannels, spec.maximumBlockSize));
+    const auto chunkSpec = chunkedSpec (spec);
+    sampleRate = chunkSpec.sampleRate;
+
+    // Re-preparing the mixers reallocates their delay lines:
+    // skip it if the spec did not change
+    if (isSameSpec (chunkSpec, preparedSpec))
+    {
+        lpfDryWet.reset();
+        hpfDryWet.reset();
+        balance.reset();
+    }
+    else
+    {
+        lpfDryWet.prepare (chunkSpec);
+        hpfDryWet.prepare (chunkSpec);
+        balance.prepare (chunkSpec);
+    }
+    preparedSpec = chunkSpec;
+
+    filter.prepare (chunkSpec);
+    if (lpfBuffer == nullptr)
+        lpfBuffer.reset (new juce::AudioBuffer<SampleType>());
+    lpfBuffer->setSize ((int) chunkSpec.numChannels, (int) chunkSpec.maximumBlockSize, false, false, true);
 }
 
 template <typename SampleType>
 void CrossoverWithBuffer<SampleType>::reset()
 {
-    dryWet.reset();
+    lpfDryWet.reset();
+    hpfDryWet.reset();
     balance.reset();
-    lpf.reset();
-    hpf.reset();
+    filter.reset();
 }
 
 //==============================================================================
@@ -27,13 +27,34 @@
 
 #pragma once
 
+#include "CrossoverFilter.h"
+#include "Chunking.h"
 #include <JuceHeader.h>
 
 /**
-    A wrapper for a pair of filters (a low-pass and a high-pass) and process
+    A listener of the band signals of a crossover, called on the audio thread
+    right after the bands are split (before the band-wise processing).
+
+    Implementations must not block nor allocate.
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class CrossoverTap
+{
+public:
+    virtual ~CrossoverTap() = default;
+
+    /** Receives the first channel of the low-pass and high-pass bands */
+    virtual void pushBands (const SampleType* lowPass, const SampleType* highPass, size_t numSamples) noexcept = 0;
+};
+
+//==============================================================================
+/**
+    A wrapper for a crossover filter (a low-pass and a high-pass) and process
     functions, each one dedicated to its own band. 
 
-    Calling the process method applies the two filters on the input signals. 
+    Calling the process method applies the filter on the input signals. 
     On each of the two signals, the respective process function is called. 
     Finally, the two signals are mixed abck together. 
 
@@ -72,6 +93,11 @@ public:
     /** Sets the process function for the HPF signal */
     void setHPFProcess (std::function<void (juce::dsp::ProcessContextReplacing<SampleType>)>);
 
+    /** Sets the listener of the band signals (nullptr for none).
+        The tap must outlive the crossover or be removed before destruction.
+    */
+    void setTap (CrossoverTap<SampleType>*) noexcept;
+
     //==============================================================================
     /** Initialises the processor. */
     void prepare (const juce::dsp::ProcessSpec&);
@@ -80,9 +106,20 @@ public:
     void reset();
 
     //==============================================================================
-    /** Processes the input and output samples supplied in the processing context. */
+    /** Processes the input and output samples supplied in the processing context.
+        The samples are processed in chunks of at most dspChunkSize samples.
+    */
     template <typename ProcessContext>
     void process (const ProcessContext& context) noexcept
+    {
+        forEachChunk (context, dspChunkSize, [this] (const auto& chunk) { processChunk (chunk); });
+    }
+
+private:
+    //==============================================================================
+    /** Processes a chunk of at most dspChunkSize samples. */
+    template <typename ProcessContext>
+    void processChunk (const ProcessContext& context) noexcept
     {
         const auto& inputBlock = context.getInputBlock();
         auto& outputBlock = context.getOutputBlock();
@@ -96,18 +133,19 @@ public:
             return;
         }
 
-        juce::dsp::AudioBlock<float> lpfBlock (*lpfBuffer);
-        jassert (lpfBlock.getNumSamples() >= outputBlock.getNumSamples());
+        jassert (lpfBuffer->getNumSamples() >= (int) outputBlock.getNumSamples());
+        auto lpfBlock = juce::dsp::AudioBlock<SampleType> (*lpfBuffer)
+                            .getSubsetChannelBlock (0, outputBlock.getNumChannels())
+                            .getSubBlock (0, outputBlock.getNumSamples());
 
-        // Process LPF path (non-replacing)
-        dryWet.pushDrySamples (inputBlock);
-        lpf.process (juce::dsp::ProcessContextNonReplacing<SampleType> (inputBlock, lpfBlock));
-        dryWet.mixWetSamples (lpfBlock);
-
-        // Process HPF path (replacing)
-        dryWet.pushDrySamples (inputBlock);
-        hpf.process (context);
-        dryWet.mixWetSamples (outputBlock);
+        // Split bands: LPF to the buffer, HPF to the output
+        lpfDryWet.pushDrySamples (inputBlock);
+        hpfDryWet.pushDrySamples (inputBlock);
+        filter.process (inputBlock, lpfBlock, outputBlock);
+        if (auto* t = tap.load (std::memory_order_acquire))
+            t->pushBands (lpfBlock.getChannelPointer (0), outputBlock.getChannelPointer (0), outputBlock.getNumSamples());
+        lpfDryWet.mixWetSamples (lpfBlock);
+        hpfDryWet.mixWetSamples (outputBlock);
 
         // Apply band-wise process functions
         process_lpf (juce::dsp::ProcessContextReplacing<SampleType> (lpfBlock));
@@ -118,18 +156,19 @@ public:
         balance.mixWetSamples (outputBlock);
     }
 
-private:
     //==============================================================================
-    juce::dsp::StateVariableTPTFilter<SampleType> lpf, hpf;
-    juce::dsp::DryWetMixer<SampleType> dryWet, balance;
+    CrossoverFilter<SampleType> filter;
+    juce::dsp::DryWetMixer<SampleType> lpfDryWet, hpfDryWet, balance;
 
     //==============================================================================
     std::unique_ptr<juce::AudioBuffer<SampleType>> lpfBuffer;
+    juce::dsp::ProcessSpec preparedSpec {};
 
     //==============================================================================
     double sampleRate = 44100.0;
     std::function<void (juce::dsp::ProcessContextReplacing<SampleType>)> process_lpf,
         process_hpf;
+    std::atomic<CrossoverTap<SampleType>*> tap { nullptr };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CrossoverWithBuffer<SampleType>)
 };
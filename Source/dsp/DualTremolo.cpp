@@ -75,12 +75,44 @@ void DualTremolo<SampleType>::sync()
     DBG ("  Target phase difference:  " << this->phase);
 }
 
+//==============================================================================
+template <typename SampleType>
+juce::uint64 DualTremolo<SampleType>::getTremoloPhaseAccumulator() const noexcept
+{
+    return this->lpfTrem.getPhaseAccumulator();
+}
+
+template <typename SampleType>
+juce::uint64 DualTremolo<SampleType>::getTremoloPhaseIncrement() const noexcept
+{
+    return this->lpfTrem.getPhaseIncrement();
+}
+
+template <typename SampleType>
+void DualTremolo<SampleType>::moveTremolos (juce::uint64 phaseAccumulator) noexcept
+{
+    // The move is taken as signed, so that small corrections in either
+    // direction are scaled as such (modulo 2^64, as in setRate)
+    const auto move = phaseAccumulator - this->lpfTrem.getPhaseAccumulator();
+    const auto backwards = (juce::int64) move < 0;
+    const auto distance = backwards ? 0 - move : move;
+
+    const juce::uint64 n = ratioNumerator, d = ratioDenominator;
+    const auto scaled = (distance / d) * n + ((distance % d) * n) / d;
+
+    this->lpfTrem.setPhaseAccumulator (phaseAccumulator);
+    this->hpfTrem.setPhaseAccumulator (this->hpfTrem.getPhaseAccumulator() + (backwards ? 0 - scaled : scaled));
+}
+
 //==============================================================================
 template <typename SampleType>
 void DualTremolo<SampleType>::update()
 {
+    // The ratio is exact to the resolution of ratioDenominator, so that
+    // the phases of the two tremolos do not drift apart
+    ratioNumerator = (juce::uint32) juce::jmax (0, juce::roundToInt (ratio * (SampleType) ratioDenominator));
     this->lpfTrem.setRate (rate);
-    this->hpfTrem.setRate (rate * ratio);
+    this->hpfTrem.setRate (rate, ratioNumerator, ratioDenominator);
 }
 
 //==============================================================================
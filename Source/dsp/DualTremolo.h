@@ -51,6 +51,23 @@ public:
     /** Syncronizes the two tremolos to be at the correct phase difference. */
     void sync();
 
+    //==============================================================================
+    /** Gets the phase accumulator of the low-pass band tremolo
+        (see PhaseControlledOscillator::getPhaseAccumulator).
+    */
+    juce::uint64 getTremoloPhaseAccumulator() const noexcept;
+
+    /** Gets the increment per sample of the phase accumulator
+        of the low-pass band tremolo.
+    */
+    juce::uint64 getTremoloPhaseIncrement() const noexcept;
+
+    /** Moves the low-pass band tremolo to a value of its phase accumulator.
+        The high-pass band tremolo is moved by the same amount, scaled by
+        the ratio, so that the two keep their phase relation.
+    */
+    void moveTremolos (juce::uint64 phaseAccumulator) noexcept;
+
 private:
     //==============================================================================
     /** Updates the processor parameters */
@@ -58,6 +75,8 @@ private:
 
     //==============================================================================
     SampleType rate = 1.0, ratio = 1.0;
+    static const juce::uint32 ratioDenominator = 1000;
+    juce::uint32 ratioNumerator = ratioDenominator;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DualTremolo<SampleType>)
 };
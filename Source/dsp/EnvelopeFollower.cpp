@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+    EnvelopeFollower.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "EnvelopeFollower.h"
+
+//==============================================================================
+template <typename SampleType>
+EnvelopeFollower<SampleType>::EnvelopeFollower()
+{
+    updateCoefficients();
+}
+
+//==============================================================================
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setMode (EnvelopeFollowerMode m)
+{
+    mode = m;
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setAmount (SampleType a)
+{
+    amount = juce::jlimit ((SampleType) -1, (SampleType) 1, a);
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setThreshold (SampleType t)
+{
+    threshold = juce::jmax (t, (SampleType) 1.0e-6);
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setAttack (SampleType ms)
+{
+    attackTime = ms;
+    updateCoefficients();
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setRelease (SampleType ms)
+{
+    releaseTime = ms;
+    updateCoefficients();
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setDecimation (size_t d)
+{
+    decimation = juce::jlimit ((size_t) 1, dspChunkSize, d);
+    updateCoefficients();
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setOnsetThreshold (SampleType t)
+{
+    onsetThreshold = juce::jmax (t, (SampleType) 0);
+}
+
+template <typename SampleType>
+bool EnvelopeFollower<SampleType>::isActive() const noexcept
+{
+    return mode != EnvelopeFollowerMode::off;
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::updateCoefficients()
+{
+    // One-pole coefficient for a time constant of t milliseconds,
+    // with one step per group of samples
+    const auto coefficient = [this] (SampleType t) {
+        return (SampleType) std::exp (-1000.0 * (double) decimation / (juce::jmax ((double) t, 0.01) * sampleRate));
+    };
+    attack = coefficient (attackTime);
+    release = coefficient (releaseTime);
+}
+
+//==============================================================================
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    updateCoefficients();
+
+    const auto chunkSpec = chunkedSpec (spec);
+    gains.resize ((size_t) chunkSpec.maximumBlockSize);
+    scratch.resize ((size_t) chunkSpec.maximumBlockSize);
+    levels.resize ((size_t) chunkSpec.maximumBlockSize);
+    reset();
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::reset()
+{
+    level = 0;
+    onset = -1;
+    armed = true;
+}
+
+//==============================================================================
+template <typename SampleType>
+const SampleType* EnvelopeFollower<SampleType>::process (const juce::dsp::AudioBlock<const SampleType>& input) noexcept
+{
+    const auto numSamples = input.getNumSamples();
+    const auto numChannels = input.getNumChannels();
+    jassert (numSamples <= gains.size());
+
+    auto* g = gains.data();
+    auto* s = scratch.data();
+    const auto n = (int) numSamples;
+    const auto rms = mode == EnvelopeFollowerMode::rms;
+
+    // Detector: peak or mean square over the channels
+    // (per group of samples, or vectorized over the block)
+    const auto numSteps = (numSamples + decimation - 1) / decimation;
+    auto* l = decimation > 1 ? levels.data() : g;
+    if (decimation > 1)
+    {
+        detectGroups (input, numSteps, rms);
+    }
+    else
+    {
+        if (rms)
+            juce::FloatVectorOperations::multiply (g, input.getChannelPointer (0), input.getChannelPointer (0), n);
+        else
+            juce::FloatVectorOperations::abs (g, input.getChannelPointer (0), n);
+
+        for (size_t channel = 1; channel < numChannels; ++channel)
+        {
+            const auto* x = input.getChannelPointer (channel);
+            if (rms)
+            {
+                juce::FloatVectorOperations::multiply (s, x, x, n);
+                juce::FloatVectorOperations::add (g, s, n);
+            }
+            else
+            {
+                juce::FloatVectorOperations::abs (s, x, n);
+                juce::FloatVectorOperations::max (g, g, s, n);
+            }
+        }
+
+        if (rms && numChannels > 1)
+            juce::FloatVectorOperations::multiply (g, (SampleType) 1 / (SampleType) numChannels, n);
+    }
+
+    // Smoothing: the comparison selects the coefficient arithmetically
+    const auto previous = level;
+    auto y = level;
+    const auto a = attack, r = release;
+    for (size_t i = 0; i < numSteps; ++i)
+    {
+        const auto x = l[i];
+        const auto coefficient = r + (a - r) * (SampleType) (x > y);
+        y = x + coefficient * (y - x);
+        l[i] = y;
+    }
+    level = y;
+
+    if (rms)
+        for (size_t i = 0; i < numSteps; ++i)
+            l[i] = std::sqrt (l[i]);
+
+    detectOnset (numSteps);
+
+    // Linear interpolation of the groups, from the last value of the previous block
+    if (decimation > 1)
+    {
+        auto from = rms ? std::sqrt (previous) : previous;
+        const auto step = (SampleType) 1 / (SampleType) decimation;
+        for (size_t k = 0, i = 0; k < numSteps; ++k)
+        {
+            const auto slope = (l[k] - from) * step;
+            for (size_t j = 1; j <= decimation && i < numSamples; ++j, ++i)
+                g[i] = from + slope * (SampleType) j;
+            from = l[k];
+        }
+    }
+
+    // Mapping: gain = 1 - max (a, 0) + a min (l / threshold, 1)
+    juce::FloatVectorOperations::multiply (g, (SampleType) 1 / threshold, n);
+    juce::FloatVectorOperations::min (g, g, (SampleType) 1, n);
+    juce::FloatVectorOperations::multiply (g, amount, n);
+    juce::FloatVectorOperations::add (g, (SampleType) 1 - juce::jmax (amount, (SampleType) 0), n);
+
+    return g;
+}
+
+template <typename SampleType>
+int EnvelopeFollower<SampleType>::getOnset() const noexcept
+{
+    return onset;
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::detectGroups (const juce::dsp::AudioBlock<const SampleType>& input, size_t numSteps, bool rms) noexcept
+{
+    const auto numSamples = input.getNumSamples();
+    const auto numChannels = input.getNumChannels();
+
+    for (size_t k = 0; k < numSteps; ++k)
+    {
+        const auto start = k * decimation;
+        const auto length = juce::jmin (decimation, numSamples - start);
+        SampleType v = 0;
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* x = input.getChannelPointer (channel) + start;
+            if (rms)
+            {
+                for (size_t i = 0; i < length; ++i)
+                    v += x[i] * x[i];
+            }
+            else
+            {
+                const auto range = juce::FloatVectorOperations::findMinAndMax (x, (int) length);
+                v = juce::jmax (v, -range.getStart(), range.getEnd());
+            }
+        }
+
+        levels[k] = rms ? v / (SampleType) (numChannels * length) : v;
+    }
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::detectOnset (size_t numSteps) noexcept
+{
+    onset = -1;
+    if (onsetThreshold <= 0)
+        return;
+
+    const auto* l = decimation > 1 ? levels.data() : gains.data();
+    const auto rearm = onsetThreshold * (SampleType) 0.5;
+    for (size_t k = 0; k < numSteps; ++k)
+    {
+        if (armed && l[k] > onsetThreshold)
+        {
+            if (onset < 0)
+                onset = (int) (k * decimation);
+            armed = false;
+        }
+        else if (l[k] < rearm)
+        {
+            armed = true;
+        }
+    }
+}
+
+//==============================================================================
+template class EnvelopeFollower<float>;
+template class EnvelopeFollower<double>;
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    EnvelopeFollower.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Chunking.h"
+#include <JuceHeader.h>
+
+/** Detectors of the envelope follower */
+enum class EnvelopeFollowerMode
+{
+    /** The envelope is not followed */
+    off,
+    /** Peak of the rectified signal, over all channels */
+    peak,
+    /** Root mean square of the signal, over all channels */
+    rms
+};
+
+/**
+    An envelope follower, which turns the level of a signal into a gain
+    per sample for the depth of a modulation.
+
+    The detector takes the peak (or the mean square) of the channels, and
+    smooths it with a one-pole filter, whose coefficient is chosen between
+    the attack and the release ones without branches. The level l is then
+    normalised to the threshold and limited to 1. With a positive amount a,
+    the gain is 1 - a + a l (loud passages are modulated more), with a
+    negative amount it is 1 + a l (quiet passages are modulated more).
+
+    The detector and the mapping are vectorized over the block, and only
+    the smoothing recursion runs sample by sample. With a decimation factor
+    D, the detector reduces each group of D samples to one value, the
+    smoothing runs once per group and the gains are interpolated linearly
+    in between: a cheap detector for a control signal, e.g. a sidechain.
+
+    The follower can also report onsets: the first point of a block where
+    the envelope rises above a threshold. It re-arms when the envelope
+    falls 6 dB below it.
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class EnvelopeFollower
+{
+public:
+    //==============================================================================
+    /** Constructor. */
+    EnvelopeFollower();
+
+    //==============================================================================
+    /** Sets the detector. */
+    void setMode (EnvelopeFollowerMode);
+
+    /** Sets the amount of the depth modulation (between -1 and 1). */
+    void setAmount (SampleType);
+
+    /** Sets the level (as a gain) above which the envelope is full scale. */
+    void setThreshold (SampleType);
+
+    /** Sets the attack time (in milliseconds). */
+    void setAttack (SampleType);
+
+    /** Sets the release time (in milliseconds). */
+    void setRelease (SampleType);
+
+    /** Sets the number of samples per detector step (1 for every sample). */
+    void setDecimation (size_t);
+
+    /** Sets the level (as a gain) of the onsets (0 for no onset detection). */
+    void setOnsetThreshold (SampleType);
+
+    /** Returns true if the envelope is followed. */
+    bool isActive() const noexcept;
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const juce::dsp::ProcessSpec&);
+
+    /** Resets the internal state variables of the processor. */
+    void reset();
+
+    /** Computes the depth gains of a block of at most dspChunkSize samples.
+        Returns a buffer with one gain per sample, valid until the next call.
+        When the envelope is not followed, the peak detector is used.
+    */
+    const SampleType* process (const juce::dsp::AudioBlock<const SampleType>&) noexcept;
+
+    /** Gets the offset (in samples) of the first onset in the last
+        processed block, or -1 if there is none.
+    */
+    int getOnset() const noexcept;
+
+private:
+    //==============================================================================
+    /** Updates the smoothing coefficients for the times and the sample rate */
+    void updateCoefficients();
+
+    /** Writes the detector value of each group of samples to the levels */
+    void detectGroups (const juce::dsp::AudioBlock<const SampleType>&, size_t numSteps, bool rms) noexcept;
+
+    /** Finds the first onset in the levels */
+    void detectOnset (size_t numSteps) noexcept;
+
+    //==============================================================================
+    EnvelopeFollowerMode mode = EnvelopeFollowerMode::off;
+    SampleType amount = 1, threshold = 1;
+    SampleType attackTime = 10, releaseTime = 200;
+    SampleType attack = 0, release = 0;
+    SampleType level = 0;
+    double sampleRate = 44100.0;
+    size_t decimation = 1;
+    std::vector<SampleType> gains, scratch, levels;
+
+    SampleType onsetThreshold = 0;
+    int onset = -1;
+    bool armed = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EnvelopeFollower<SampleType>)
+};
@@ -30,6 +30,7 @@
 template <typename SampleType>
 HarmonicTremolo<SampleType>::HarmonicTremolo()
 {
+    sidechainEnvelope.setDecimation (sidechainDecimation);
 }
 
 template <typename SampleType>
@@ -90,6 +91,70 @@ void HarmonicTremolo<SampleType>::setTremoloShape (PhaseControlledOscillatorWave
     hpfTrem.setShape (f);
 }
 
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloControlRate (bool f)
+{
+    lpfTrem.setControlRate (f);
+    hpfTrem.setControlRate (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloFastMath (bool f)
+{
+    lpfTrem.setFastMath (f);
+    hpfTrem.setFastMath (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloOversampling (size_t order)
+{
+    lpfTrem.setOversampling (order);
+    hpfTrem.setOversampling (order);
+    dryWet.setWetLatency ((SampleType) getLatencyInSamples());
+}
+
+template <typename SampleType>
+int HarmonicTremolo<SampleType>::getLatencyInSamples() const noexcept
+{
+    // Both bands have the same latency
+    return lpfTrem.getLatencyInSamples();
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloWavetables (typename Wavetable<SampleType>::Ptr a, typename Wavetable<SampleType>::Ptr b)
+{
+    lpfTrem.setWavetables (a, b);
+    hpfTrem.setWavetables (a, b);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloMorph (SampleType f)
+{
+    lpfTrem.setMorph (f);
+    hpfTrem.setMorph (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloSpread (SampleType f)
+{
+    lpfTrem.setSpread (f);
+    hpfTrem.setSpread (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloSpreadMode (PhaseControlledOscillatorSpreadMode f)
+{
+    lpfTrem.setSpreadMode (f);
+    hpfTrem.setSpreadMode (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloChannelLayout (const juce::AudioChannelSet& layout)
+{
+    lpfTrem.setChannelLayout (layout);
+    hpfTrem.setChannelLayout (layout);
+}
+
 template <typename SampleType>
 void HarmonicTremolo<SampleType>::setTremoloMix (SampleType f)
 {
@@ -103,14 +168,120 @@ void HarmonicTremolo<SampleType>::setMix (SampleType f)
     dryWet.setWetMixProportion (f);
 }
 
+//==============================================================================
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setEnvelopeMode (EnvelopeFollowerMode f)
+{
+    envelope.setMode (f);
+    sidechainEnvelope.setMode (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setEnvelopeAmount (SampleType f)
+{
+    envelope.setAmount (f);
+    sidechainEnvelope.setAmount (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setEnvelopeThreshold (SampleType f)
+{
+    envelope.setThreshold (f);
+    sidechainEnvelope.setThreshold (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setEnvelopeSidechain (bool f)
+{
+    envelopeSidechain = f;
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setSidechainRetrigger (bool f)
+{
+    retrigger = f;
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setSidechainThreshold (SampleType f)
+{
+    sidechainEnvelope.setOnsetThreshold (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setSidechain (const juce::dsp::AudioBlock<const SampleType>& block) noexcept
+{
+    sidechain = block;
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setEnvelopeAttack (SampleType f)
+{
+    envelope.setAttack (f);
+    sidechainEnvelope.setAttack (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setEnvelopeRelease (SampleType f)
+{
+    envelope.setRelease (f);
+    sidechainEnvelope.setRelease (f);
+}
+
+//==============================================================================
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setTremoloMetering (bool f)
+{
+    lpfTrem.setMetering (f);
+    hpfTrem.setMetering (f);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::setCrossoverTap (CrossoverTap<SampleType>* tap) noexcept
+{
+    crossover.setTap (tap);
+}
+
+template <typename SampleType>
+SampleType HarmonicTremolo<SampleType>::getTremoloModulation (int band) const noexcept
+{
+    return band == 0 ? lpfTrem.getModulation() : hpfTrem.getModulation();
+}
+
+template <typename SampleType>
+SampleType HarmonicTremolo<SampleType>::getTremoloLevel (int band) const noexcept
+{
+    return band == 0 ? lpfTrem.getLevel() : hpfTrem.getLevel();
+}
+
+template <typename SampleType>
+SampleType HarmonicTremolo<SampleType>::getTremoloPhaseDifference()
+{
+    const auto twoPi = juce::MathConstants<SampleType>::twoPi;
+    const auto d = std::fmod (hpfTrem.getOffset() + hpfTrem.getPhase() - lpfTrem.getPhase(), twoPi);
+    return d < 0 ? d + twoPi : d;
+}
+
 //==============================================================================
 template <typename SampleType>
 void HarmonicTremolo<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
 {
-    dryWet.prepare (spec);
-    crossover.prepare (spec);
-    lpfTrem.prepare (spec);
-    hpfTrem.prepare (spec);
+    const auto chunkSpec = chunkedSpec (spec);
+
+    // Re-preparing the mixer reallocates its delay line:
+    // skip it if the spec did not change
+    if (isSameSpec (chunkSpec, preparedSpec))
+        dryWet.reset();
+    else
+        dryWet.prepare (chunkSpec);
+    preparedSpec = chunkSpec;
+
+    crossover.prepare (chunkSpec);
+    envelope.prepare (chunkSpec);
+    sidechainEnvelope.prepare (chunkSpec);
+    lpfTrem.prepare (chunkSpec);
+    hpfTrem.prepare (chunkSpec);
+    dryWet.setWetLatency ((SampleType) getLatencyInSamples());
     crossover.setLPFProcess (std::bind (
         &Tremolo<SampleType>::template process<juce::dsp::ProcessContextReplacing<SampleType>>,
         &lpfTrem,
@@ -126,11 +297,29 @@ void HarmonicTremolo<SampleType>::reset()
 {
     dryWet.reset();
     crossover.reset();
+    envelope.reset();
+    sidechainEnvelope.reset();
     lpfTrem.reset();
     hpfTrem.reset();
     hpfTrem.advance (phase);
 }
 
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::skipTremolos (juce::uint64 numSamples) noexcept
+{
+    lpfTrem.skip (numSamples);
+    hpfTrem.skip (numSamples);
+}
+
+template <typename SampleType>
+void HarmonicTremolo<SampleType>::restartTremolos() noexcept
+{
+    // The initial phases, as after reset
+    lpfTrem.setPhaseAccumulator (0);
+    hpfTrem.setPhaseAccumulator (0);
+    hpfTrem.advance (phase);
+}
+
 //==============================================================================
 template class HarmonicTremolo<float>;
 template class HarmonicTremolo<double>;
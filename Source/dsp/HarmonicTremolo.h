@@ -27,7 +27,9 @@
 
 #pragma once
 
+#include "Chunking.h"
 #include "CrossoverWithBuffer.h"
+#include "EnvelopeFollower.h"
 #include "Tremolo.h"
 #include <JuceHeader.h>
 
@@ -76,6 +78,46 @@ public:
     /** Sets the wave shape of the tremolo. */
     void setTremoloShape (PhaseControlledOscillatorWaveShape);
 
+    /** Enables the control-rate evaluation of the tremolo LFOs
+        (see PhaseControlledOscillator::setControlRate).
+    */
+    void setTremoloControlRate (bool);
+
+    /** Enables the fast approximation of the sine shape of the tremolos
+        (see PhaseControlledOscillator::setFastMath).
+    */
+    void setTremoloFastMath (bool);
+
+    /** Sets the oversampling of the tremolos, as a power of two
+        (see Tremolo::setOversampling). Once prepared, call this between
+        chunks on the processing thread: the latency changes with it.
+    */
+    void setTremoloOversampling (size_t);
+
+    /** Gets the latency (in samples) of the processor */
+    int getLatencyInSamples() const noexcept;
+
+    /** Sets the two wavetables of the tremolo, for the wavetable shape. */
+    void setTremoloWavetables (typename Wavetable<SampleType>::Ptr, typename Wavetable<SampleType>::Ptr);
+
+    /** Sets the morph between the two wavetables of the tremolo
+        (between 0 for the first table and 1 for the second).
+    */
+    void setTremoloMorph (SampleType);
+
+    /** Sets the phase difference (in radians) of the tremolo between the
+        first and the last channel (e.g. pi for an auto-pan).
+    */
+    void setTremoloSpread (SampleType);
+
+    /** Sets how the phase spread of the tremolo is applied over the channels. */
+    void setTremoloSpreadMode (PhaseControlledOscillatorSpreadMode);
+
+    /** Sets the layout of the channels, for the pairs spread mode of the
+        tremolo. It is applied by the next call to prepare.
+    */
+    void setTremoloChannelLayout (const juce::AudioChannelSet&);
+
     /** Sets the amount of dry and wet signal in the output of the
         tremolo (between 0 for full dry and 1 for full wet).
     */
@@ -86,6 +128,65 @@ public:
     */
     void setMix (SampleType);
 
+    //==============================================================================
+    /** Sets the detector of the envelope of the input, which drives the
+        depth of the tremolos (see EnvelopeFollower).
+    */
+    void setEnvelopeMode (EnvelopeFollowerMode);
+
+    /** Sets the amount of the depth modulation by the envelope (between -1 and 1). */
+    void setEnvelopeAmount (SampleType);
+
+    /** Sets the level (as a gain) above which the envelope is full scale. */
+    void setEnvelopeThreshold (SampleType);
+
+    /** Sets the attack time (in milliseconds) of the envelope. */
+    void setEnvelopeAttack (SampleType);
+
+    /** Sets the release time (in milliseconds) of the envelope. */
+    void setEnvelopeRelease (SampleType);
+
+    /** Makes the envelope follow the sidechain instead of the input.
+        Without a sidechain, the depth is then not modulated.
+    */
+    void setEnvelopeSidechain (bool);
+
+    /** Enables the restart of the tremolos on the onsets of the sidechain. */
+    void setSidechainRetrigger (bool);
+
+    /** Sets the level (as a gain) of the onsets of the sidechain. */
+    void setSidechainThreshold (SampleType);
+
+    /** Sets the sidechain of the next chunk to process (an empty block
+        for none). It must have the same number of samples as the chunk.
+    */
+    void setSidechain (const juce::dsp::AudioBlock<const SampleType>&) noexcept;
+
+    /** Samples per step of the sidechain detector */
+    static constexpr size_t sidechainDecimation = 16;
+
+    //==============================================================================
+    /** Enables the metering of the two tremolos. */
+    void setTremoloMetering (bool);
+
+    /** Gets the last modulation value of a tremolo
+        (0 for the low-pass band, 1 for the high-pass band).
+    */
+    SampleType getTremoloModulation (int band) const noexcept;
+
+    /** Gets the peak level of a band in the last processed chunk
+        (0 for the low-pass band, 1 for the high-pass band).
+    */
+    SampleType getTremoloLevel (int band) const noexcept;
+
+    /** Gets the phase difference (in radians, between 0 and 2 pi)
+        of the high-pass band tremolo with respect to the low-pass one.
+    */
+    SampleType getTremoloPhaseDifference();
+
+    /** Sets the listener of the crossover band signals (nullptr for none). */
+    void setCrossoverTap (CrossoverTap<SampleType>*) noexcept;
+
     //==============================================================================
     /** Initialises the processor. */
     void prepare (const juce::dsp::ProcessSpec&);
@@ -93,10 +194,35 @@ public:
     /** Resets the internal state variables of the processor. */
     void reset();
 
+    /** Advances the tremolo LFOs by a number of samples, as if they had been
+        processed (see PhaseControlledOscillator::skip). The filters are not
+        advanced.
+    */
+    void skipTremolos (juce::uint64 numSamples) noexcept;
+
+    /** Restarts the tremolo LFOs at their initial phases */
+    void restartTremolos() noexcept;
+
     //==============================================================================
-    /** Processes the input and output samples supplied in the processing context. */
+    /** Processes the input and output samples supplied in the processing context.
+        The samples are processed in chunks of at most dspChunkSize samples.
+    */
     template <typename ProcessContext>
     void process (const ProcessContext& context) noexcept
+    {
+        forEachChunk (context, dspChunkSize, [this] (const auto& chunk) { processChunk (chunk); });
+    }
+
+protected:
+    //==============================================================================
+    Tremolo<SampleType> lpfTrem, hpfTrem;
+    SampleType phase = juce::MathConstants<SampleType>::halfPi;
+
+private:
+    //==============================================================================
+    /** Processes a chunk of at most dspChunkSize samples. */
+    template <typename ProcessContext>
+    void processChunk (const ProcessContext& context) noexcept
     {
         const auto& inputBlock = context.getInputBlock();
         auto& outputBlock = context.getOutputBlock();
@@ -111,19 +237,64 @@ public:
         }
 
         dryWet.pushDrySamples (inputBlock);
-        crossover.process (context);
+
+        // The envelope of the input or of the sidechain drives the depth of
+        // both tremolos, which process this chunk in one go. The sidechain
+        // detector only runs when the host feeds a sidechain
+        const SampleType* depthGains = nullptr;
+        auto onset = -1;
+        const auto followSidechain = envelopeSidechain && envelope.isActive();
+        if (sidechain.getNumChannels() > 0 && (followSidechain || retrigger))
+        {
+            jassert (sidechain.getNumSamples() == inputBlock.getNumSamples());
+            const auto* gains = sidechainEnvelope.process (sidechain);
+            if (followSidechain)
+                depthGains = gains;
+
+            if (retrigger)
+                onset = sidechainEnvelope.getOnset();
+        }
+        else if (! envelopeSidechain && envelope.isActive())
+        {
+            depthGains = envelope.process (inputBlock);
+        }
+        sidechain = {};
+
+        lpfTrem.setDepthModulation (depthGains);
+        hpfTrem.setDepthModulation (depthGains);
+
+        if (onset < 0)
+        {
+            crossover.process (context);
+        }
+        else
+        {
+            // The tremolos restart on the sample of the onset: the samples
+            // before it are processed with the running phases
+            const auto split = (size_t) onset;
+            const auto processCrossover = [this] (const auto& part) { crossover.process (part); };
+            if (split > 0)
+                processSubContext (context, 0, split, processCrossover);
+
+            restartTremolos();
+            if (depthGains != nullptr)
+            {
+                lpfTrem.setDepthModulation (depthGains + split);
+                hpfTrem.setDepthModulation (depthGains + split);
+            }
+            processSubContext (context, split, outputBlock.getNumSamples() - split, processCrossover);
+        }
+
         dryWet.mixWetSamples (outputBlock);
     }
 
-protected:
-    //==============================================================================
-    Tremolo<SampleType> lpfTrem, hpfTrem;
-    SampleType phase = juce::MathConstants<SampleType>::halfPi;
-
-private:
     //==============================================================================
     CrossoverWithBuffer<SampleType> crossover;
-    juce::dsp::DryWetMixer<SampleType> dryWet;
+    EnvelopeFollower<SampleType> envelope, sidechainEnvelope;
+    juce::dsp::AudioBlock<const SampleType> sidechain;
+    bool envelopeSidechain = false, retrigger = false;
+    juce::dsp::DryWetMixer<SampleType> dryWet { Tremolo<SampleType>::maxOversamplingLatency };
+    juce::dsp::ProcessSpec preparedSpec {};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HarmonicTremolo<SampleType>)
 };
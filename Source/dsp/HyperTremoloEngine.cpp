@@ -0,0 +1,309 @@
+/*
+  ==============================================================================
+
+    HyperTremoloEngine.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "HyperTremoloEngine.h"
+
+//==============================================================================
+HyperTremoloEngine::HyperTremoloEngine()
+{
+    // The LFOs are below 20 Hz: by default, evaluate them at control rate
+    applyOptions();
+
+    processor.setTremoloWavetables (Wavetable<float>::fromShape<WaveShapes::Sine<float>>(),
+                                    Wavetable<float>::fromShape<WaveShapes::Sawtooth<float>>());
+
+    for (size_t i = 0; i < numParameters; ++i)
+        parameterValues[i].store (parameterTable[i].defaultValue, std::memory_order_relaxed);
+    applyParameterValues();
+}
+
+//==============================================================================
+float HyperTremoloEngine::getParameterValue (ParameterIndex index) const noexcept
+{
+    return parameterValues[index].load (std::memory_order_relaxed);
+}
+
+void HyperTremoloEngine::setParameterValue (ParameterIndex index, float value) noexcept
+{
+    // The flag is set after the value: the processing thread that sees
+    // the flag also sees the value
+    static_assert (numParameters <= 64, "One bit per parameter");
+    storeParameterValue (index, value);
+    changedParameters.fetch_or ((juce::uint64) 1 << index, std::memory_order_release);
+}
+
+void HyperTremoloEngine::storeParameterValue (ParameterIndex index, float value) noexcept
+{
+    parameterValues[index].store (value, std::memory_order_relaxed);
+}
+
+void HyperTremoloEngine::applyParameterValues()
+{
+    // Values set after the flags are cleared are applied again on the next block
+    changedParameters.exchange (0, std::memory_order_acquire);
+    for (auto& spec : parameterTable)
+        spec.apply (*this);
+}
+
+void HyperTremoloEngine::applyChangedParameterValues() noexcept
+{
+    const auto changed = changedParameters.exchange (0, std::memory_order_acquire);
+    if (changed == 0)
+        return;
+
+    for (size_t i = 0; i < numParameters; ++i)
+        if ((changed >> i) & 1)
+            parameterTable[i].apply (*this);
+}
+
+void HyperTremoloEngine::applyTremoloRate()
+{
+    // A follower of the LFO clock runs at the rate of the master
+    const auto followed = followedRate.load (std::memory_order_relaxed);
+    if (followed >= 0.0f)
+    {
+        processor.setTremoloRate (followed);
+        return;
+    }
+
+    const auto throughZero = getParameterValue (tremZeroParameter) != 0.0f;
+    processor.setTremoloRate (getParameterValue (tremRateParameter) / (throughZero + 1.0f));
+}
+
+//==============================================================================
+void HyperTremoloEngine::setControlRate (bool f) noexcept
+{
+    controlRate.store (f, std::memory_order_relaxed);
+}
+
+bool HyperTremoloEngine::getControlRate() const noexcept
+{
+    return controlRate.load (std::memory_order_relaxed);
+}
+
+void HyperTremoloEngine::setFastMath (bool f) noexcept
+{
+    fastMath.store (f, std::memory_order_relaxed);
+}
+
+bool HyperTremoloEngine::getFastMath() const noexcept
+{
+    return fastMath.load (std::memory_order_relaxed);
+}
+
+void HyperTremoloEngine::applyOptions() noexcept
+{
+    const auto newControlRate = getControlRate();
+    if (newControlRate != appliedControlRate)
+    {
+        appliedControlRate = newControlRate;
+        processor.setTremoloControlRate (newControlRate);
+    }
+
+    const auto newFastMath = getFastMath();
+    if (newFastMath != appliedFastMath)
+    {
+        appliedFastMath = newFastMath;
+        processor.setTremoloFastMath (newFastMath);
+    }
+}
+
+//==============================================================================
+DualTremolo<float>& HyperTremoloEngine::getProcessor() noexcept
+{
+    return processor;
+}
+
+int HyperTremoloEngine::getLatencyInSamples() const noexcept
+{
+    return processor.getLatencyInSamples();
+}
+
+//==============================================================================
+void HyperTremoloEngine::setChannelLayout (const juce::AudioChannelSet& layout)
+{
+    processor.setTremoloChannelLayout (layout);
+}
+
+void HyperTremoloEngine::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    // Re-preparing the mixer reallocates its delay line:
+    // skip it if the spec did not change
+    const auto chunkSpec = chunkedSpec (spec);
+    if (! isSameSpec (chunkSpec, preparedSpec))
+        dryWet.prepare (chunkSpec);
+    preparedSpec = chunkSpec;
+
+    gain.prepare (chunkSpec);
+    gain.setRampDurationSeconds (0.05);
+    oversamplingOrder = (size_t) getParameterValue (tremOversamplingParameter);
+    processor.setTremoloOversampling (oversamplingOrder);
+    processor.prepare (spec);
+
+    // The latency of the oversampling is compensated in the dry signal
+    dryWet.setWetLatency ((float) getLatencyInSamples());
+
+    // Enforce parameter value update, then start from the new values:
+    // a prepared engine does not depend on what it processed before
+    applyOptions();
+    applyParameterValues();
+    reset();
+}
+
+void HyperTremoloEngine::reset()
+{
+    gain.reset();
+    dryWet.reset();
+    processor.reset();
+    clock.unlock();
+}
+
+void HyperTremoloEngine::skip (juce::uint64 numSamples) noexcept
+{
+    processor.skipTremolos (numSamples);
+    clock.skip (numSamples);
+}
+
+void HyperTremoloEngine::setSidechain (const juce::dsp::AudioBlock<const float>& block) noexcept
+{
+    sidechain = block;
+}
+
+void HyperTremoloEngine::applyOversampling() noexcept
+{
+    const auto order = (size_t) getParameterValue (tremOversamplingParameter);
+    if (order == oversamplingOrder)
+        return;
+
+    oversamplingOrder = order;
+    processor.setTremoloOversampling (order);
+    dryWet.setWetLatency ((float) getLatencyInSamples());
+}
+
+//==============================================================================
+/** Ratios of the choices of the clockRatio parameter */
+static const struct
+{
+    juce::uint32 numerator, denominator;
+} clockRatios[] = { { 1, 4 }, { 1, 3 }, { 1, 2 }, { 2, 3 }, { 1, 1 }, { 3, 2 }, { 2, 1 }, { 3, 1 }, { 4, 1 } };
+
+void HyperTremoloEngine::syncClock (size_t numSamples) noexcept
+{
+    const auto mode = static_cast<LfoClock::Mode> ((int) getParameterValue (clockModeParameter));
+    const auto& ratio = clockRatios[(size_t) getParameterValue (clockRatioParameter)];
+    const auto offset = getParameterValue (clockOffsetParameter) / 360.0;
+    const auto rate = clock.beginBlock (mode, processor, ratio.numerator, ratio.denominator, offset, preparedSpec.sampleRate, numSamples);
+
+    if (rate != followedRate.load (std::memory_order_relaxed))
+    {
+        followedRate.store (rate, std::memory_order_relaxed);
+        applyTremoloRate();
+    }
+}
+
+//==============================================================================
+using Spec = ParameterSpec<HyperTremoloEngine>;
+
+const Spec HyperTremoloEngine::parameterTable[numParameters] = {
+    { "gain", "Gain", Spec::linear, -20.0f, 20.0f, 0.01f, 1.0f, 0.0f, "dB", nullptr, [] (HyperTremoloEngine& p) {
+         p.gain.setGainDecibels (p.getParameterValue (gainParameter));
+     } },
+    { "mix", "Mix", Spec::linear, 0.0f, 1.0f, 0.001f, 1.0f, 1.0f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.dryWet.setWetMixProportion (p.getParameterValue (mixParameter));
+     } },
+    { "tremRate", "Rate", Spec::linear, 0.0f, 20.0f, 0.001f, 0.333f, 2.5f, "Hz", nullptr, [] (HyperTremoloEngine& p) {
+         p.applyTremoloRate();
+     } },
+    { "tremRatio", "Ratio", Spec::logarithmic, 0.1f, 10.0f, 0.001f, 1.0f, 1.0f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setTremoloRatio (p.getParameterValue (tremRatioParameter));
+     } },
+    { "tremMix", "Depth", Spec::linear, 0.0f, 1.0f, 0.001f, 1.0f, 0.5f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setTremoloMix (p.getParameterValue (tremMixParameter));
+     } },
+    { "tremShape", "Shape", Spec::choice, 0.0f, 2.0f, 1.0f, 1.0f, 0.0f, "", "Sine|Sawtooth|Wavetable", [] (HyperTremoloEngine& p) {
+         p.processor.setTremoloShape (static_cast<PhaseControlledOscillatorWaveShape> ((int) p.getParameterValue (tremShapeParameter)));
+     } },
+    { "tremMorph", "Morph", Spec::linear, 0.0f, 1.0f, 0.001f, 1.0f, 0.0f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setTremoloMorph (p.getParameterValue (tremMorphParameter));
+     } },
+    { "tremSpread", "Spread", Spec::linear, 0.0f, 180.0f, 0.1f, 1.0f, 0.0f, "deg", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setTremoloSpread (juce::degreesToRadians (p.getParameterValue (tremSpreadParameter)));
+     } },
+    { "tremLink", "Link", Spec::choice, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, "", "All|Pairs", [] (HyperTremoloEngine& p) {
+         p.processor.setTremoloSpreadMode (static_cast<PhaseControlledOscillatorSpreadMode> ((int) p.getParameterValue (tremLinkParameter)));
+     } },
+    { "tremZero", "Through-0", Spec::toggle, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setTremoloThroughZero (p.getParameterValue (tremZeroParameter) != 0.0f);
+         p.applyTremoloRate();
+     } },
+    { "tremSync", "Sync", Spec::toggle, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, "", nullptr, [] (HyperTremoloEngine& p) {
+         if (p.getParameterValue (tremSyncParameter) != 0.0f)
+             p.processor.sync();
+     } },
+    { "xoverFreq", "Crossover", Spec::logarithmic, 50.0f, 20000.0f, 0.01f, 1.0f, 1000.0f, "Hz", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setCrossoverFrequency (p.getParameterValue (xoverFreqParameter));
+     } },
+    { "xoverReson", "Resonance", Spec::logarithmic, 0.125f, 4.0f, 0.001f, 1.0f, 1.0f / juce::MathConstants<float>::sqrt2, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setCrossoverResonance (p.getParameterValue (xoverResonParameter));
+     } },
+    { "xoverBalance", "Balance", Spec::linear, 0.0f, 1.0f, 0.001f, 1.0f, 0.5f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setCrossoverBalance (p.getParameterValue (xoverBalanceParameter));
+     } },
+    { "xoverMix", "Harmonic", Spec::linear, 0.0f, 1.0f, 0.001f, 1.0f, 1.0f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setCrossoverMix (p.getParameterValue (xoverMixParameter));
+     } },
+    // The clock parameters are read at the start of each block (see syncClock)
+    { "clockMode", "Clock", Spec::choice, 0.0f, 2.0f, 1.0f, 1.0f, 0.0f, "", "Off|Master|Follow", [] (HyperTremoloEngine&) {} },
+    { "clockRatio", "Clock Ratio", Spec::choice, 0.0f, 8.0f, 1.0f, 1.0f, 4.0f, "", "1/4|1/3|1/2|2/3|1|3/2|2|3|4", [] (HyperTremoloEngine&) {} },
+    { "clockOffset", "Clock Offset", Spec::linear, 0.0f, 360.0f, 0.1f, 1.0f, 0.0f, "deg", nullptr, [] (HyperTremoloEngine&) {} },
+    { "envMode", "Envelope", Spec::choice, 0.0f, 2.0f, 1.0f, 1.0f, 0.0f, "", "Off|Peak|RMS", [] (HyperTremoloEngine& p) {
+         p.processor.setEnvelopeMode (static_cast<EnvelopeFollowerMode> ((int) p.getParameterValue (envModeParameter)));
+     } },
+    { "envAmount", "Env Amount", Spec::linear, -1.0f, 1.0f, 0.001f, 1.0f, 1.0f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setEnvelopeAmount (p.getParameterValue (envAmountParameter));
+     } },
+    { "envThreshold", "Env Threshold", Spec::linear, -60.0f, 0.0f, 0.1f, 1.0f, -20.0f, "dB", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setEnvelopeThreshold (juce::Decibels::decibelsToGain (p.getParameterValue (envThresholdParameter)));
+     } },
+    { "envAttack", "Env Attack", Spec::logarithmic, 0.1f, 100.0f, 0.01f, 1.0f, 10.0f, "ms", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setEnvelopeAttack (p.getParameterValue (envAttackParameter));
+     } },
+    { "envRelease", "Env Release", Spec::logarithmic, 10.0f, 2000.0f, 0.1f, 1.0f, 200.0f, "ms", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setEnvelopeRelease (p.getParameterValue (envReleaseParameter));
+     } },
+    { "envSource", "Env Source", Spec::choice, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, "", "Input|Sidechain", [] (HyperTremoloEngine& p) {
+         p.processor.setEnvelopeSidechain (p.getParameterValue (envSourceParameter) != 0.0f);
+     } },
+    { "scRetrigger", "SC Retrigger", Spec::toggle, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, "", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setSidechainRetrigger (p.getParameterValue (scRetriggerParameter) != 0.0f);
+     } },
+    { "scThreshold", "SC Threshold", Spec::linear, -60.0f, 0.0f, 0.1f, 1.0f, -24.0f, "dB", nullptr, [] (HyperTremoloEngine& p) {
+         p.processor.setSidechainThreshold (juce::Decibels::decibelsToGain (p.getParameterValue (scThresholdParameter)));
+     } },
+    // The oversampling is read at the start of each block (see applyOversampling)
+    { "tremOversampling", "Oversampling", Spec::choice, 0.0f, 2.0f, 1.0f, 1.0f, 0.0f, "", "Off|2x|4x", [] (HyperTremoloEngine&) {} }
+};
@@ -0,0 +1,243 @@
+/*
+  ==============================================================================
+
+    HyperTremoloEngine.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../Commons.h"
+#include "Chunking.h"
+#include "DualTremolo.h"
+#include "LfoClockBus.h"
+#include "ParameterSpec.h"
+#include <JuceHeader.h>
+
+/**
+    The whole HyperTremolo effect without the plugin wrapper: the dual
+    tremolo, the output gain and the dry/wet mix, driven by the table
+    of parameters. The tremolos can share their clock with the other
+    engines of the process (see LfoClock).
+
+    The parameter values are stored atomically by any thread, and marked as
+    changed: the processing thread applies the changed ones to the DSP at
+    the start of the next block, so that the DSP is only ever touched by it.
+    Nothing is allocated after prepare.
+
+    @tags{DSP}
+*/
+class HyperTremoloEngine
+{
+public:
+    //==============================================================================
+    /** Indices of the parameters, in the order of the parameter table */
+    enum ParameterIndex
+    {
+        gainParameter,
+        mixParameter,
+        tremRateParameter,
+        tremRatioParameter,
+        tremMixParameter,
+        tremShapeParameter,
+        tremMorphParameter,
+        tremSpreadParameter,
+        tremLinkParameter,
+        tremZeroParameter,
+        tremSyncParameter,
+        xoverFreqParameter,
+        xoverResonParameter,
+        xoverBalanceParameter,
+        xoverMixParameter,
+        clockModeParameter,
+        clockRatioParameter,
+        clockOffsetParameter,
+        envModeParameter,
+        envAmountParameter,
+        envThresholdParameter,
+        envAttackParameter,
+        envReleaseParameter,
+        envSourceParameter,
+        scRetriggerParameter,
+        scThresholdParameter,
+        tremOversamplingParameter,
+        numParameters
+    };
+
+    /** The parameters: their IDs, ranges and DSP setters */
+    static const ParameterSpec<HyperTremoloEngine> parameterTable[numParameters];
+
+    //==============================================================================
+    /** Constructor. All parameters are set to their default value. */
+    HyperTremoloEngine();
+
+    //==============================================================================
+    /** Gets the current value of a parameter */
+    float getParameterValue (ParameterIndex) const noexcept;
+
+    /** Sets the value of a parameter, from any thread. It is applied to the
+        DSP at the start of the next call to process.
+        The value is expected to be legal (see ParameterSpec::constrain).
+    */
+    void setParameterValue (ParameterIndex, float) noexcept;
+
+    /** Sets the value of a parameter, without applying it to the DSP */
+    void storeParameterValue (ParameterIndex, float) noexcept;
+
+    /** Applies the current value of each parameter to the DSP.
+        Only call it from the processing thread, or while not processing.
+    */
+    void applyParameterValues();
+
+    //==============================================================================
+    /** Enables the control-rate evaluation of the sine LFOs (see
+        PhaseControlledOscillator::setControlRate), from any thread. It is
+        applied at the start of the next call to process. The default is
+        set by HYPERTREMOLO_CONTROL_RATE.
+    */
+    void setControlRate (bool) noexcept;
+
+    /** Returns true if the control-rate evaluation is enabled */
+    bool getControlRate() const noexcept;
+
+    /** Enables the fast approximation of the sine shape of the LFOs (see
+        WaveShapes::FastSine), from any thread. It is applied at the start
+        of the next call to process. The default is set by
+        HYPERTREMOLO_FAST_MATH.
+    */
+    void setFastMath (bool) noexcept;
+
+    /** Returns true if the fast approximation of the sine is enabled */
+    bool getFastMath() const noexcept;
+
+    //==============================================================================
+    /** Gets the dual tremolo, e.g. for metering or for the wavetables */
+    DualTremolo<float>& getProcessor() noexcept;
+
+    /** Gets the latency (in samples) of the effect. It changes with the
+        oversampling parameter, at the start of the next processed block.
+    */
+    int getLatencyInSamples() const noexcept;
+
+    //==============================================================================
+    /** Sets the layout of the processed channels, which defines the pairs
+        of the linked spread of the tremolo. It is applied by the next call
+        to prepare: without a layout of the prepared size, the canonical
+        layout of the number of channels is assumed.
+    */
+    void setChannelLayout (const juce::AudioChannelSet&);
+
+    /** Initialises the effect, and applies the parameter values. */
+    void prepare (const juce::dsp::ProcessSpec&);
+
+    /** Resets the internal state variables of the effect. */
+    void reset();
+
+    /** Advances the LFOs by a number of samples, as if they had been
+        processed with the current parameters. The filters and mixers are
+        not advanced: to continue a render from a given sample, process some
+        samples before it to warm them up. The LFO clock is expected to be
+        off.
+    */
+    void skip (juce::uint64 numSamples) noexcept;
+
+    //==============================================================================
+    /** Sets the sidechain of the next call to process (an empty block for
+        none). It must have as many samples as the processed block.
+    */
+    void setSidechain (const juce::dsp::AudioBlock<const float>&) noexcept;
+
+    /** Processes the samples supplied in the processing context, in chunks of
+        at most dspChunkSize samples. The callback is called after each chunk.
+    */
+    template <typename ProcessContext, typename ChunkCallback>
+    void process (const ProcessContext& context, ChunkCallback&& afterChunk) noexcept
+    {
+        applyChangedParameterValues();
+        applyOptions();
+        applyOversampling();
+        syncClock (context.getInputBlock().getNumSamples());
+
+        // The sidechain is split along with the main chunks
+        size_t start = 0;
+        forEachChunk (context, dspChunkSize, [this, &afterChunk, &start] (const auto& chunk) {
+            const auto numSamples = chunk.getInputBlock().getNumSamples();
+            if (sidechain.getNumChannels() > 0)
+                processor.setSidechain (sidechain.getSubBlock (start, numSamples));
+            start += numSamples;
+
+            dryWet.pushDrySamples (chunk.getInputBlock());
+            processor.process (chunk);
+            gain.process (chunk);
+            dryWet.mixWetSamples (chunk.getOutputBlock());
+            afterChunk();
+        });
+        sidechain = {};
+    }
+
+    /** Processes the samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        process (context, [] {});
+    }
+
+private:
+    //==============================================================================
+    /** Applies the parameters set since the last call to the DSP */
+    void applyChangedParameterValues() noexcept;
+
+    /** Applies the evaluation options of the LFOs set since the last block */
+    void applyOptions() noexcept;
+
+    /** Applies the rate of the tremolo, which depends on the through-zero flag */
+    void applyTremoloRate();
+
+    /** Applies the oversampling order of the tremolos at the start of a
+        block, with the latency it implies
+    */
+    void applyOversampling() noexcept;
+
+    /** Publishes or follows the LFO clock at the start of a block */
+    void syncClock (size_t numSamples) noexcept;
+
+    //==============================================================================
+    juce::dsp::DryWetMixer<float> dryWet { Tremolo<float>::maxOversamplingLatency };
+    DualTremolo<float> processor;
+    juce::dsp::Gain<float> gain;
+    juce::dsp::ProcessSpec preparedSpec {};
+    std::array<std::atomic<float>, numParameters> parameterValues;
+    std::atomic<juce::uint64> changedParameters { 0 };
+    size_t oversamplingOrder = 0;
+    std::atomic<bool> controlRate { HYPERTREMOLO_CONTROL_RATE != 0 };
+    std::atomic<bool> fastMath { HYPERTREMOLO_FAST_MATH != 0 };
+    bool appliedControlRate = false, appliedFastMath = false;
+
+    // The rate of the master, while following the LFO clock (negative otherwise)
+    LfoClock clock;
+    std::atomic<float> followedRate { -1.0f };
+
+    juce::dsp::AudioBlock<const float> sidechain;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HyperTremoloEngine)
+};
@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+
+    LfoClockBus.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "LfoClockBus.h"
+
+/** Full 128-bit product of two 64-bit integers */
+static void multiply (juce::uint64 a, juce::uint64 b, juce::uint64& high, juce::uint64& low) noexcept
+{
+    const auto a0 = a & 0xffffffff, a1 = a >> 32;
+    const auto b0 = b & 0xffffffff, b1 = b >> 32;
+    const auto p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    const auto middle = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+
+    low = (middle << 32) | (p00 & 0xffffffff);
+    high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+}
+
+//==============================================================================
+LfoClockBus::LfoClockBus()
+{
+}
+
+bool LfoClockBus::claimMaster (const void* owner) noexcept
+{
+    const void* expected = nullptr;
+    if (master.compare_exchange_strong (expected, owner))
+    {
+        // The state of the previous master is not valid anymore
+        epoch.fetch_add (1);
+        return true;
+    }
+    return expected == owner;
+}
+
+void LfoClockBus::releaseMaster (const void* owner) noexcept
+{
+    master.compare_exchange_strong (owner, nullptr);
+}
+
+void LfoClockBus::publish (const State& state) noexcept
+{
+    const auto s = sequence.load (std::memory_order_relaxed);
+    sequence.store (s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    cycles.store (state.cycles, std::memory_order_relaxed);
+    phase.store (state.phase, std::memory_order_relaxed);
+    increment.store (state.increment, std::memory_order_relaxed);
+    position.store (state.position, std::memory_order_relaxed);
+    sampleRate.store (state.sampleRate, std::memory_order_relaxed);
+    publishedEpoch.store (epoch.load (std::memory_order_relaxed), std::memory_order_relaxed);
+
+    sequence.store (s + 2, std::memory_order_release);
+}
+
+bool LfoClockBus::read (State& state) const noexcept
+{
+    if (master.load (std::memory_order_acquire) == nullptr)
+        return false;
+
+    for (int attempt = 0; attempt < maxReadAttempts; ++attempt)
+    {
+        const auto before = sequence.load (std::memory_order_acquire);
+        if ((before & 1) != 0)
+            continue;
+
+        State s;
+        s.cycles = cycles.load (std::memory_order_relaxed);
+        s.phase = phase.load (std::memory_order_relaxed);
+        s.increment = increment.load (std::memory_order_relaxed);
+        s.position = position.load (std::memory_order_relaxed);
+        s.sampleRate = sampleRate.load (std::memory_order_relaxed);
+        s.epoch = publishedEpoch.load (std::memory_order_relaxed);
+
+        std::atomic_thread_fence (std::memory_order_acquire);
+        if (sequence.load (std::memory_order_relaxed) != before)
+            continue;
+
+        // A new master that has not published yet
+        if (s.epoch != epoch.load (std::memory_order_relaxed))
+            return false;
+
+        state = s;
+        return true;
+    }
+    return false;
+}
+
+//==============================================================================
+void LfoClockBus::advance (juce::uint64& cycles, juce::uint64& phase, juce::uint64 increment, juce::int64 numSamples) noexcept
+{
+    const auto n = numSamples < 0 ? 0 - (juce::uint64) numSamples : (juce::uint64) numSamples;
+    juce::uint64 high, low;
+    multiply (increment, n, high, low);
+
+    if (numSamples >= 0)
+    {
+        const auto sum = phase + low;
+        cycles += high + (sum < phase ? 1 : 0);
+        phase = sum;
+    }
+    else
+    {
+        const auto difference = phase - low;
+        cycles -= high + (difference > phase ? 1 : 0);
+        phase = difference;
+    }
+}
+
+juce::uint64 LfoClockBus::scale (juce::uint64 cycles, juce::uint64 phase, juce::uint32 numerator, juce::uint32 denominator) noexcept
+{
+    jassert (denominator > 0);
+
+    // 2^64 = q d + r
+    const juce::uint64 d = denominator;
+    auto q = ~juce::uint64() / d;
+    auto r = ~juce::uint64() % d + 1;
+    if (r == d)
+    {
+        ++q;
+        r = 0;
+    }
+
+    // floor ((cycles 2^64 + phase) / d) modulo 2^64,
+    // where only the cycles modulo d matter
+    const auto c = cycles % d;
+    const auto quotient = c * q + phase / d + (c * r + phase % d) / d;
+    return quotient * numerator;
+}
+
+//==============================================================================
+LfoClock::LfoClock()
+{
+}
+
+LfoClock::~LfoClock()
+{
+    release();
+}
+
+//==============================================================================
+float LfoClock::beginBlock (Mode mode,
+                            DualTremolo<float>& tremolos,
+                            juce::uint32 ratioNumerator,
+                            juce::uint32 ratioDenominator,
+                            double offset,
+                            double sampleRate,
+                            size_t numSamples) noexcept
+{
+    auto rate = -1.0f;
+
+    if (mode == master)
+    {
+        if (! isMaster && bus->claimMaster (this))
+        {
+            isMaster = true;
+            hasPublished = false;
+        }
+
+        if (isMaster)
+            publishTremolos (tremolos, sampleRate);
+        isLocked = false;
+    }
+    else
+    {
+        release();
+
+        if (mode == follow)
+            rate = followTremolos (tremolos, ratioNumerator, ratioDenominator, offset, sampleRate);
+        else
+            isLocked = false;
+    }
+
+    position += numSamples;
+    lastNumSamples = numSamples;
+    return rate;
+}
+
+void LfoClock::skip (juce::uint64 numSamples) noexcept
+{
+    position += numSamples;
+    lastNumSamples += numSamples;
+}
+
+void LfoClock::unlock() noexcept
+{
+    isLocked = false;
+}
+
+//==============================================================================
+void LfoClock::publishTremolos (DualTremolo<float>& tremolos, double sampleRate) noexcept
+{
+    const auto phase = tremolos.getTremoloPhaseAccumulator();
+
+    if (! hasPublished)
+    {
+        published.cycles = 0;
+        hasPublished = true;
+    }
+    else
+    {
+        // Count the periods of the last block. If the phase is not the
+        // predicted one (the rate changed in the block), take the nearest
+        // unwrapped phase
+        auto predicted = published.phase;
+        LfoClockBus::advance (published.cycles, predicted, published.increment, (juce::int64) lastNumSamples);
+
+        const auto error = (juce::int64) (phase - predicted);
+        if (error > 0 && phase < predicted)
+            ++published.cycles;
+        else if (error < 0 && phase > predicted)
+            --published.cycles;
+    }
+
+    published.phase = phase;
+    published.increment = tremolos.getTremoloPhaseIncrement();
+    published.position = position;
+    published.sampleRate = sampleRate;
+    bus->publish (published);
+}
+
+float LfoClock::followTremolos (DualTremolo<float>& tremolos,
+                                juce::uint32 ratioNumerator,
+                                juce::uint32 ratioDenominator,
+                                double offset,
+                                double sampleRate) noexcept
+{
+    LfoClockBus::State state;
+    if (! bus->read (state) || state.sampleRate != sampleRate)
+    {
+        isLocked = false;
+        return -1.0f;
+    }
+
+    // Lock the start of this block to the last block of the master
+    if (! isLocked || state.epoch != lockedEpoch)
+    {
+        anchor = position - state.position;
+        lockedEpoch = state.epoch;
+        isLocked = true;
+    }
+
+    // Phase of the master at the start of this block, extrapolated from
+    // the published one: the last block of the master may be before or
+    // after it, depending on the processing order of the host
+    auto cycles = state.cycles;
+    auto phase = state.phase;
+    LfoClockBus::advance (cycles, phase, state.increment, (juce::int64) (position - anchor - state.position));
+
+    const auto fraction = offset - std::floor (offset);
+    const auto offsetSteps = (juce::uint64) std::ldexp (fraction, 64);
+    tremolos.moveTremolos (LfoClockBus::scale (cycles, phase, ratioNumerator, ratioDenominator) + offsetSteps);
+
+    return (float) (std::ldexp ((double) state.increment, -64) * sampleRate * ratioNumerator / ratioDenominator);
+}
+
+void LfoClock::release() noexcept
+{
+    if (isMaster)
+    {
+        bus->releaseMaster (this);
+        isMaster = false;
+    }
+}
@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    LfoClockBus.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DualTremolo.h"
+#include <JuceHeader.h>
+
+/**
+    A process-wide clock for the tremolo LFOs, which instances can opt in
+    to share (see juce::SharedResourcePointer).
+
+    One master publishes the state of its low-pass band LFO once per block:
+    its unwrapped phase (the whole periods and the phase accumulator, see
+    PhaseControlledOscillator::setRate), the increment per sample and the
+    position of the block in the samples processed by the master. Followers
+    derive their phase from the last published state.
+
+    The state is published with a sequence lock: there is a single writer
+    (the master) and the readers retry a bounded number of times if they
+    catch a write in progress. Nothing blocks or allocates.
+
+    @tags{DSP}
+*/
+class LfoClockBus
+{
+public:
+    //==============================================================================
+    /** The published state of the master LFO */
+    struct State
+    {
+        /** Unwrapped phase at the start of the block, in whole periods
+            and phase accumulator steps
+        */
+        juce::uint64 cycles = 0, phase = 0;
+
+        /** Phase increment per sample */
+        juce::uint64 increment = 0;
+
+        /** Position of the start of the block, in samples processed by the master */
+        juce::uint64 position = 0;
+
+        double sampleRate = 0.0;
+
+        /** Incremented each time the bus is claimed by a master */
+        juce::uint32 epoch = 0;
+    };
+
+    //==============================================================================
+    LfoClockBus();
+
+    /** Makes an owner the master of the bus.
+        Returns false if the bus already has another master.
+    */
+    bool claimMaster (const void* owner) noexcept;
+
+    /** Releases the bus, if the owner is its master */
+    void releaseMaster (const void* owner) noexcept;
+
+    /** Publishes the state of the master LFO. Only the master may call this:
+        the epoch of the state is set by the bus.
+    */
+    void publish (const State&) noexcept;
+
+    /** Reads the last state published by the current master. Returns false
+        if there is none, or if a consistent copy could not be read.
+    */
+    bool read (State&) const noexcept;
+
+    //==============================================================================
+    /** Moves an unwrapped phase by a (possibly negative) number of samples */
+    static void advance (juce::uint64& cycles, juce::uint64& phase, juce::uint64 increment, juce::int64 numSamples) noexcept;
+
+    /** Scales an unwrapped phase by a ratio, modulo a period.
+        The denominator is expected to be small.
+    */
+    static juce::uint64 scale (juce::uint64 cycles, juce::uint64 phase, juce::uint32 numerator, juce::uint32 denominator) noexcept;
+
+private:
+    //==============================================================================
+    static constexpr int maxReadAttempts = 4;
+
+    std::atomic<const void*> master { nullptr };
+    std::atomic<juce::uint32> epoch { 0 };
+
+    // Sequence lock: odd while a state is being written
+    std::atomic<juce::uint32> sequence { 0 };
+    std::atomic<juce::uint64> cycles { 0 }, phase { 0 }, increment { 0 }, position { 0 };
+    std::atomic<double> sampleRate { 0.0 };
+    std::atomic<juce::uint32> publishedEpoch { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LfoClockBus)
+};
+
+//==============================================================================
+/**
+    The connection of one effect to the LfoClockBus of the process.
+
+    A master publishes the phase of its tremolos at the start of each block.
+    A follower maps its own sample count to the one of the master when it
+    locks, and then sets the phase of its tremolos at the start of each block
+    to the published one, times a ratio, plus an offset. As the mapping is
+    fixed, the phase does not depend on the order in which the host
+    processes the instances, and there is no drift.
+
+    A follower falls back to its own rate when there is no master, or when
+    the master runs at a different sample rate. Only one instance can be the
+    master: the others that ask for it run on their own until it is released.
+
+    @tags{DSP}
+*/
+class LfoClock
+{
+public:
+    //==============================================================================
+    enum Mode
+    {
+        off,
+        master,
+        follow
+    };
+
+    //==============================================================================
+    LfoClock();
+    ~LfoClock();
+
+    //==============================================================================
+    /** Synchronises the tremolos at the start of a block of a number of samples.
+
+        For a follower, the ratio scales the published phase and the offset
+        (in periods, between 0 and 1) is added to it. Returns the rate (in Hz)
+        of the low-pass band tremolo of a locked follower, which is to be
+        applied to the tremolos, or a negative value if they run at their
+        own rate.
+    */
+    float beginBlock (Mode mode,
+                      DualTremolo<float>& tremolos,
+                      juce::uint32 ratioNumerator,
+                      juce::uint32 ratioDenominator,
+                      double offset,
+                      double sampleRate,
+                      size_t numSamples) noexcept;
+
+    /** Advances the position by a number of samples, without processing */
+    void skip (juce::uint64 numSamples) noexcept;
+
+    /** Unlocks a follower, which locks again on the next block (e.g. after a reset) */
+    void unlock() noexcept;
+
+private:
+    //==============================================================================
+    void publishTremolos (DualTremolo<float>&, double sampleRate) noexcept;
+    float followTremolos (DualTremolo<float>&, juce::uint32, juce::uint32, double, double sampleRate) noexcept;
+    void release() noexcept;
+
+    //==============================================================================
+    juce::SharedResourcePointer<LfoClockBus> bus;
+
+    // The samples processed so far, and the last published state of a master
+    juce::uint64 position = 0;
+    LfoClockBus::State published;
+    juce::uint64 lastNumSamples = 0;
+    bool isMaster = false, hasPublished = false;
+
+    // Offset from the positions of the master to those of a follower
+    juce::uint64 anchor = 0;
+    juce::uint32 lockedEpoch = 0;
+    bool isLocked = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LfoClock)
+};
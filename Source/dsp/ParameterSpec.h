@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    ParameterSpec.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Static description of a parameter: its ID, name, range and default
+    value, and the function that applies its value to a target.
+
+    A table of these drives both the creation of the plugin parameters and
+    their application to the DSP, so that adding a parameter is one table
+    entry.
+*/
+template <typename Target>
+struct ParameterSpec
+{
+    enum Kind
+    {
+        linear,
+        logarithmic,
+        choice,
+        toggle
+    };
+
+    const char* id;
+    const char* name;
+    Kind kind;
+
+    /** Range of the value (for choices, the range of the indices) */
+    float minimum, maximum, interval, skew;
+    float defaultValue;
+    const char* label;
+
+    /** Choice names, separated by '|' */
+    const char* choices;
+
+    /** Applies the current value of the parameter to the target */
+    void (*apply) (Target&);
+
+    /** Limits a value to the range and snaps it to the interval,
+        as the plugin parameters do
+    */
+    float constrain (float value) const noexcept
+    {
+        value = juce::jlimit (minimum, maximum, value);
+        if (interval > 0.0f)
+            value = juce::jlimit (minimum, maximum, minimum + interval * std::round ((value - minimum) / interval));
+        return value;
+    }
+};
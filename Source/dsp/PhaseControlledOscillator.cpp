@@ -39,65 +39,194 @@ SampleType moduloTwoPi (SampleType a)
 
 //==============================================================================
 template <typename SampleType>
-SampleType sineWaveFunc (SampleType phase)
+PhaseControlledOscillator<SampleType>::PhaseControlledOscillator()
+    : lookup(), morph(0), spread(0), offset(0)
 {
-    return (std::sin (phase) + ((SampleType) 1)) / ((SampleType) 2);
+    setShape(PhaseControlledOscillatorWaveShape::sine);
 }
 
 template <typename SampleType>
-SampleType sawtoothWaveFunc (SampleType phase)
+PhaseControlledOscillator<SampleType>::~PhaseControlledOscillator()
 {
-    return fmod (
-        phase / juce::MathConstants<SampleType>::twoPi,
-        (SampleType) 1.0);
+    delete pendingWavetables.exchange (nullptr);
+    delete retiredWavetables.exchange (nullptr);
 }
 
 //==============================================================================
 template <typename SampleType>
-PhaseControlledOscillator<SampleType>::PhaseControlledOscillator()
-    : lookup(), offset(0)
+void PhaseControlledOscillator<SampleType>::setShape (std::function<SampleType (SampleType)> newWaveShapeFunc, size_t resolution)
 {
-    setShape(PhaseControlledOscillatorWaveShape::sine);
+    lookup.initialise(newWaveShapeFunc, 0, juce::MathConstants<SampleType>::twoPi, resolution);
+    useLookup = true;
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setShape (PhaseControlledOscillatorWaveShape newWaveShape)
+{
+    waveShape = newWaveShape;
+    useLookup = false;
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setWavetables (typename Wavetable<SampleType>::Ptr a, typename Wavetable<SampleType>::Ptr b)
+{
+    // Release the tables replaced by the last swap, then publish the new
+    // ones (replacing the ones that were not swapped in yet)
+    delete retiredWavetables.exchange (nullptr);
+    delete pendingWavetables.exchange (new WavetablePair { std::move (a), std::move (b) });
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setMorph (SampleType newMorph)
+{
+    morph.setTargetValue (newMorph);
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setSpread (SampleType newSpread)
+{
+    spread.setTargetValue (newSpread);
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setSpreadMode (PhaseControlledOscillatorSpreadMode newSpreadMode)
+{
+    spreadMode = newSpreadMode;
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setChannelLayout (const juce::AudioChannelSet& newChannelLayout)
+{
+    channelLayout = newChannelLayout;
 }
 
 //==============================================================================
+/** Channels of the pairs spread mode: the left channel and its right counterpart */
+static const std::pair<juce::AudioChannelSet::ChannelType, juce::AudioChannelSet::ChannelType> channelPairs[] = {
+    { juce::AudioChannelSet::left, juce::AudioChannelSet::right },
+    { juce::AudioChannelSet::leftSurround, juce::AudioChannelSet::rightSurround },
+    { juce::AudioChannelSet::leftCentre, juce::AudioChannelSet::rightCentre },
+    { juce::AudioChannelSet::leftSurroundSide, juce::AudioChannelSet::rightSurroundSide },
+    { juce::AudioChannelSet::leftSurroundRear, juce::AudioChannelSet::rightSurroundRear },
+    { juce::AudioChannelSet::wideLeft, juce::AudioChannelSet::wideRight },
+    { juce::AudioChannelSet::topFrontLeft, juce::AudioChannelSet::topFrontRight },
+    { juce::AudioChannelSet::topRearLeft, juce::AudioChannelSet::topRearRight }
+};
+
+/** Computes the fraction of the spread of each channel in the pairs mode */
 template <typename SampleType>
-void PhaseControlledOscillator<SampleType>::setShape (std::function<SampleType (SampleType)> newWaveShapeFunc)
+static std::vector<SampleType> computePairWeights (const juce::AudioChannelSet& layout, size_t numChannels)
 {
-    lookup.initialise(newWaveShapeFunc, 0, juce::MathConstants<SampleType>::twoPi, lookup_size);
+    std::vector<SampleType> weights (numChannels, (SampleType) 0);
+
+    // Discrete channels are paired in order, an odd last one is left alone
+    if (layout.isDiscreteLayout())
+    {
+        for (size_t channel = 1; channel < numChannels; channel += 2)
+            weights[channel] = (SampleType) 1;
+        return weights;
+    }
+
+    for (const auto& pair : channelPairs)
+    {
+        const auto left = layout.getChannelIndexForType (pair.first);
+        const auto right = layout.getChannelIndexForType (pair.second);
+        if (left >= 0 && right >= 0 && (size_t) right < numChannels)
+            weights[(size_t) right] = (SampleType) 1;
+    }
+    return weights;
 }
 
+//==============================================================================
 template <typename SampleType>
-void PhaseControlledOscillator<SampleType>::setShape (PhaseControlledOscillatorWaveShape newWaveShape)
+SampleType PhaseControlledOscillator<SampleType>::waveShapeFunc (SampleType p)
 {
-    switch (newWaveShape)
+    if (useLookup)
+        return lookup.processSampleUnchecked (juce::MathConstants<SampleType>::twoPi * WaveShapes::wrapToUnit (p));
+    switch (waveShape)
     {
         case PhaseControlledOscillatorWaveShape::sine:
-            setShape (sineWaveFunc<SampleType>);
-            break;
+            return fastMath ? WaveShapes::FastSine<SampleType>::process (p)
+                            : WaveShapes::Sine<SampleType>::process (p);
         case PhaseControlledOscillatorWaveShape::sawtooth:
-            setShape (sawtoothWaveFunc<SampleType>);
-            break;
+            return WaveShapes::Sawtooth<SampleType>::process (p);
+        case PhaseControlledOscillatorWaveShape::wavetable:
+        {
+            if (wavetables == nullptr || wavetables->a == nullptr || wavetables->b == nullptr)
+                return WaveShapes::Sine<SampleType>::process (p);
+            const auto u = WaveShapes::wrapToUnit (p);
+            const auto va = wavetables->a->processUnit (u);
+            return va + morph.getTargetValue() * (wavetables->b->processUnit (u) - va);
+        }
     }
+    jassertfalse;
+    return 0;
 }
 
 template <typename SampleType>
-SampleType PhaseControlledOscillator<SampleType>::waveShapeFunc (SampleType p)
+void PhaseControlledOscillator<SampleType>::setRate (SampleType newRate, juce::uint32 numerator, juce::uint32 denominator)
 {
-    return lookup.processSampleUnchecked(moduloTwoPi(p));
+    jassert (denominator > 0);
+    rate = newRate;
+    rateNumerator = numerator;
+    rateDenominator = juce::jmax ((juce::uint32) 1, denominator);
+    updateIncrement();
 }
 
 template <typename SampleType>
-void PhaseControlledOscillator<SampleType>::setRate (SampleType newRate)
+void PhaseControlledOscillator<SampleType>::updateIncrement() noexcept
 {
-    rate = juce::MathConstants<SampleType>::twoPi * newRate;
+    // Fraction of period per sample, with 53 bits (negative rates wrap around)
+    const auto base = fromRadians (juce::MathConstants<double>::twoPi * (double) rate / (double) sampleRate);
+
+    // Exact base * numerator / denominator, modulo 2^64
+    const juce::uint64 n = rateNumerator, d = rateDenominator;
+    increment = (base / d) * n + ((base % d) * n) / d;
+    updateDecimation();
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setControlRate (bool f)
+{
+    controlRate = f;
+    updateDecimation();
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setFastMath (bool f)
+{
+    fastMath = f;
+}
+
+template <typename SampleType>
+size_t PhaseControlledOscillator<SampleType>::getControlRateDecimation() const noexcept
+{
+    return decimation;
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::updateDecimation() noexcept
+{
+    if (! controlRate)
+    {
+        decimation = 1;
+        return;
+    }
+
+    // Linear interpolation error on (sin + 1) / 2: (K d)^2 / 16 <= tolerance
+    const auto step = (double) toRadians (increment);
+    const auto d = juce::jmin (step, juce::MathConstants<double>::twoPi - step);
+    const auto maxSpacing = 4.0 * std::sqrt (controlRateTolerance);
+    decimation = d * (double) maxDecimation <= maxSpacing
+                     ? maxDecimation
+                     : juce::jmax ((size_t) 1, (size_t) (maxSpacing / d));
 }
 
 //==============================================================================
 template <typename SampleType>
 SampleType PhaseControlledOscillator<SampleType>::getPhase (size_t delay)
 {
-    return phase.phase + samplesToPhase (delay);
+    return toRadians (phase + increment * (juce::uint64) delay);
 }
 
 //==============================================================================
@@ -105,19 +234,56 @@ template <typename SampleType>
 void PhaseControlledOscillator<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
 {
     sampleRate = (SampleType) spec.sampleRate;
+    nodes.resize ((size_t) spec.maximumBlockSize + 1);
+    updateIncrement();
     offset.reset (sampleRate, 0.050);
+    morph.reset (sampleRate, 0.050);
+    spread.reset (sampleRate, 0.050);
+    swapPendingWavetables();
+
+    const auto layout = channelLayout.size() == (int) spec.numChannels
+                            ? channelLayout
+                            : juce::AudioChannelSet::canonicalChannelSet ((int) spec.numChannels);
+    pairWeights = computePairWeights<SampleType> (layout, spec.numChannels);
 }
 
 template <typename SampleType>
 void PhaseControlledOscillator<SampleType>::reset()
 {
-    phase.reset();
+    phase = 0;
+    offset.setCurrentAndTargetValue (offset.getTargetValue());
+    morph.setCurrentAndTargetValue (morph.getTargetValue());
+    spread.setCurrentAndTargetValue (spread.getTargetValue());
 }
 
 template <typename SampleType>
 void PhaseControlledOscillator<SampleType>::advance (SampleType p)
 {
-    phase.advance (p);
+    phase += fromRadians ((double) p);
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::skip (juce::uint64 numSamples) noexcept
+{
+    phase += increment * numSamples;
+}
+
+template <typename SampleType>
+juce::uint64 PhaseControlledOscillator<SampleType>::getPhaseAccumulator() const noexcept
+{
+    return phase;
+}
+
+template <typename SampleType>
+juce::uint64 PhaseControlledOscillator<SampleType>::getPhaseIncrement() const noexcept
+{
+    return increment;
+}
+
+template <typename SampleType>
+void PhaseControlledOscillator<SampleType>::setPhaseAccumulator (juce::uint64 p) noexcept
+{
+    phase = p;
 }
 
 template <typename SampleType>
@@ -150,10 +316,10 @@ SampleType PhaseControlledOscillator<SampleType>::getOffset()
 
 //==============================================================================
 template <typename SampleType>
-SampleType PhaseControlledOscillator<SampleType>::samplesToPhase (size_t samples)
-{
-    return rate * samples / sampleRate;
-}
+constexpr size_t PhaseControlledOscillator<SampleType>::maxDecimation;
+
+template <typename SampleType>
+constexpr double PhaseControlledOscillator<SampleType>::controlRateTolerance;
 
 //==============================================================================
 template class PhaseControlledOscillator<float>;
@@ -27,13 +27,28 @@
 
 #pragma once
 
+#include "WaveShapes.h"
+#include "Wavetable.h"
 #include <JuceHeader.h>
 
 /** Wave shapes for oscillator */
 enum class PhaseControlledOscillatorWaveShape
 {
     sine,
-    sawtooth
+    sawtooth,
+    wavetable
+};
+
+/** Ways of spreading the oscillator phase over multiple channels */
+enum class PhaseControlledOscillatorSpreadMode
+{
+    /** The spread is distributed evenly from the first to the last channel */
+    all,
+    /** The spread is applied within each pair of channels (e.g. L/R, Ls/Rs),
+        the unpaired channels (e.g. C, LFE) follow the first of the pairs
+        (see PhaseControlledOscillator::setChannelLayout)
+    */
+    pairs
 };
 
 /**
@@ -49,17 +64,91 @@ public:
     /** Constructor. */
     PhaseControlledOscillator();
 
-    /** Sets the wave shape function of the oscillator. */
-    void setShape (std::function<SampleType (SampleType)>);
+    /** Destructor. */
+    ~PhaseControlledOscillator();
+
+    /** Sets the wave shape function of the oscillator.
+        The function is approximated with a lookup table of the given resolution.
+    */
+    void setShape (std::function<SampleType (SampleType)>, size_t resolution = 64);
 
     /** Sets the wave shape function of the oscillator. */
     void setShape (PhaseControlledOscillatorWaveShape);
 
-    /** Call the approximated wave shape function */
+    /** Sets the two wavetables to morph between, for the wavetable shape.
+        It can be called from another thread than the processing one: the
+        tables are swapped in at the start of the next call to process,
+        without locking, and the replaced ones are released by the next
+        call to this method (or by the destructor).
+    */
+    void setWavetables (typename Wavetable<SampleType>::Ptr, typename Wavetable<SampleType>::Ptr);
+
+    /** Sets the morph between the two wavetables
+        (between 0 for the first table and 1 for the second).
+    */
+    void setMorph (SampleType);
+
+    /** Sets the phase difference (in radians) between the channels,
+        according to the spread mode.
+    */
+    void setSpread (SampleType);
+
+    /** Sets how the spread is applied over the channels. */
+    void setSpreadMode (PhaseControlledOscillatorSpreadMode);
+
+    /** Sets the layout of the channels, which defines the pairs of the pairs
+        spread mode: each left channel is paired with its right counterpart.
+        Discrete layouts are paired in order, and layouts that do not match
+        the prepared number of channels are replaced by the canonical one.
+        It is applied by the next call to prepare.
+    */
+    void setChannelLayout (const juce::AudioChannelSet&);
+
+    /** Returns true if the channels have different phases,
+        false if all channels share the same modulator.
+    */
+    bool hasSpread() const noexcept
+    {
+        return spread.isSmoothing() || spread.getTargetValue() != 0;
+    }
+
+    /** Call the wave shape function (on the processing thread) */
     SampleType waveShapeFunc (SampleType);
 
-    /** Sets the rate (in Hz) of the oscillator */
-    void setRate (SampleType);
+    /** Sets the rate (in Hz) of the oscillator, scaled by an exact ratio.
+
+        The phase is an unsigned 64-bit accumulator, where a full period is
+        2^64 steps and wrapping is the free integer overflow. The increment
+        per sample is derived from the rate, and then multiplied by the ratio
+        in integer arithmetic: oscillators set with the same rate keep an
+        exact ratio of their phases, without drift.
+    */
+    void setRate (SampleType, juce::uint32 numerator = 1, juce::uint32 denominator = 1);
+
+    /** Enables the control-rate mode.
+
+        The wave shape is evaluated every K samples only, and linearly
+        interpolated in between. K is the largest spacing (up to
+        maxDecimation) for which the interpolation error on the raised sine
+        stays below controlRateTolerance: with a phase increment d per sample,
+        the error is at most (K d)^2 / 16, so K = 4 sqrt (tolerance) / d.
+        The bound only holds for the sine: the other shapes (the sawtooth,
+        the wavetables and custom shapes) may have corners or jumps, which
+        the interpolation would smear over K samples, and are always
+        rendered at audio rate.
+    */
+    void setControlRate (bool);
+
+    /** Enables the fast approximation of the sine shape
+        (see WaveShapes::FastSine for the error bound).
+    */
+    void setFastMath (bool);
+
+    /** Gets the current spacing (in samples) of the control-rate evaluation */
+    size_t getControlRateDecimation() const noexcept;
+
+    static constexpr size_t maxDecimation = 32;
+    static constexpr double controlRateTolerance = 1.0e-4;
 
     //==============================================================================
     /** Gets the current phase of the oscillator.
@@ -72,12 +161,29 @@ public:
     /** Initialises the oscillator. */
     void prepare (const juce::dsp::ProcessSpec&);
 
-    /** Resets the internal state variables of the oscillator. */
+    /** Resets the internal state variables of the oscillator.
+        The smoothed values jump to their targets.
+    */
     void reset();
 
     /** Advances the oscillator by the given phase amount. */
     void advance (SampleType);
 
+    /** Advances the oscillator by a number of samples, as if they had been
+        processed: the phase is the same, exactly. The smoothed values are
+        not advanced.
+    */
+    void skip (juce::uint64 numSamples) noexcept;
+
+    /** Gets the phase accumulator (see setRate) */
+    juce::uint64 getPhaseAccumulator() const noexcept;
+
+    /** Gets the increment of the phase accumulator per sample */
+    juce::uint64 getPhaseIncrement() const noexcept;
+
+    /** Sets the phase accumulator, e.g. to follow an external clock */
+    void setPhaseAccumulator (juce::uint64) noexcept;
+
     /** Sets the phase offset target value */
     void setOffset (SampleType);
 
@@ -88,13 +194,17 @@ public:
     SampleType getOffset();
 
     //==============================================================================
-    /** Writes the output samples for the oscillator waveshape. */
+    /** Writes the output samples for the oscillator waveshape.
+        With a non-zero spread, each channel is rendered with its own phase
+        offset, otherwise all channels get the same modulator.
+    */
     template <typename ProcessContext>
     void process (const ProcessContext& context) noexcept
     {
         auto& outputBlock = context.getOutputBlock();
         const auto numChannels = outputBlock.getNumChannels();
         const auto numSamples = outputBlock.getNumSamples();
+        swapPendingWavetables();
 
         if (context.isBypassed)
         {
@@ -102,34 +212,275 @@ public:
             return;
         }
 
-        if (numChannels > 0)
+        if (numChannels > 0 && numSamples > 0)
         {
-            auto* outputSamples = outputBlock.getChannelPointer (0);
+            auto* phases = outputBlock.getChannelPointer (0);
+            fillPhases (phases, numSamples);
 
-            for (size_t i = 0; i < numSamples; ++i)
-                outputSamples[i] = waveShapeFunc (getPhase (i) + offset.getNextValue());
-            auto firstChannelBlock = outputBlock.getSingleChannelBlock (0);
-            for (size_t channel = 1; channel < numChannels; ++channel)
-                outputBlock.getSingleChannelBlock (channel).copyFrom (firstChannelBlock);
+            // The morph ramp is computed once, so that it is the same on all channels
+            const auto morphStart = morph.getCurrentValue();
+            const auto morphStep = (morph.skip ((int) numSamples) - morphStart) / (SampleType) numSamples;
+
+            if (numChannels > 1 && hasSpread())
+            {
+                // The last channel holds the spread values until it is rendered
+                auto* spreads = outputBlock.getChannelPointer (numChannels - 1);
+                fillSmoothed (spread, spreads, numSamples);
+                for (size_t channel = 1; channel < numChannels; ++channel)
+                {
+                    auto* samples = outputBlock.getChannelPointer (channel);
+                    const auto weight = spreadWeight (channel, numChannels);
+                    for (size_t i = 0; i < numSamples; ++i)
+                        samples[i] = phases[i] + weight * spreads[i];
+                    applyCurrentShape (samples, numSamples, morphStart, morphStep);
+                }
+                applyCurrentShape (phases, numSamples, morphStart, morphStep);
+            }
+            else
+            {
+                applyCurrentShape (phases, numSamples, morphStart, morphStep);
+                auto firstChannelBlock = outputBlock.getSingleChannelBlock (0);
+                for (size_t channel = 1; channel < numChannels; ++channel)
+                    outputBlock.getSingleChannelBlock (channel).copyFrom (firstChannelBlock);
+            }
         }
-        advance (samplesToPhase (numSamples));
+        phase += increment * (juce::uint64) numSamples;
     }
 
 private:
     //==============================================================================
-    /** Convert a value in samples to the corresponding oscillator phase */
-    SampleType samplesToPhase (size_t);
+    /** Converts a phase of the accumulator to radians, in [0, 2 pi) */
+    static SampleType toRadians (juce::uint64 p) noexcept
+    {
+        return (SampleType) ((double) (p >> 11) * (juce::MathConstants<double>::twoPi / 9007199254740992.0));
+    }
+
+    /** Converts a phase in radians (any value) to a phase of the accumulator */
+    static juce::uint64 fromRadians (double p) noexcept
+    {
+        return ((juce::uint64) (WaveShapes::wrapToUnit (p) * 9007199254740992.0)) << 11;
+    }
+
+    /** Updates the increment for the current rate, ratio and sample rate */
+    void updateIncrement() noexcept;
+
+    /** Swaps in the wavetables set since the last call, if any. The replaced
+        ones are left for the setting thread to release: until it does, new
+        tables cannot arrive, since it releases them before setting others
+    */
+    void swapPendingWavetables() noexcept
+    {
+        if (retiredWavetables.load() != nullptr)
+            return;
+
+        if (auto* pending = pendingWavetables.exchange (nullptr))
+        {
+            retiredWavetables.store (wavetables.release());
+            wavetables.reset (pending);
+        }
+    }
+
+    /** Writes the phase of the next samples (offset included) to a buffer.
+        The accumulator is converted once per buffer, so the floating-point
+        phases stay within a buffer of the exact ones.
+    */
+    void fillPhases (SampleType* samples, size_t numSamples) noexcept
+    {
+        const auto step = toRadians (increment);
+        const auto current = toRadians (phase);
+        if (offset.isSmoothing())
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+                samples[i] = current + step * (SampleType) i + offset.getNextValue();
+        }
+        else
+        {
+            const auto start = current + offset.getTargetValue();
+            for (size_t i = 0; i < numSamples; ++i)
+                samples[i] = start + step * (SampleType) i;
+        }
+    }
+
+    /** Gets the fraction of the spread applied to a channel */
+    SampleType spreadWeight (size_t channel, size_t numChannels) const noexcept
+    {
+        switch (spreadMode)
+        {
+            case PhaseControlledOscillatorSpreadMode::all:
+                return (SampleType) channel / (SampleType) (numChannels - 1);
+            case PhaseControlledOscillatorSpreadMode::pairs:
+                return channel < pairWeights.size() ? pairWeights[channel] : (SampleType) 0;
+        }
+        return 0;
+    }
+
+    /** Writes the next values of a smoothed value to a buffer */
+    static void fillSmoothed (juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear>& value,
+                              SampleType* samples,
+                              size_t numSamples) noexcept
+    {
+        if (value.isSmoothing())
+            for (size_t i = 0; i < numSamples; ++i)
+                samples[i] = value.getNextValue();
+        else
+            std::fill (samples, samples + numSamples, value.getTargetValue());
+    }
+
+    /** Updates the control-rate spacing for the current rate and sample rate */
+    void updateDecimation() noexcept;
+
+    /** Replaces a buffer of phases with the values of the current wave shape,
+        at control rate if enabled and the shape is the sine
+    */
+    void applyCurrentShape (SampleType* samples,
+                            size_t numSamples,
+                            SampleType morphStart,
+                            SampleType morphStep) noexcept
+    {
+        const auto isSine = ! useLookup && waveShape == PhaseControlledOscillatorWaveShape::sine;
+        if (decimation > 1 && isSine && numSamples + 1 <= nodes.size())
+            applyShapeAtControlRate (samples, numSamples, morphStart, morphStep);
+        else
+            applyShapeAtAudioRate (samples, numSamples, morphStart, morphStep);
+    }
+
+    /** Evaluates the wave shape on every K-th phase and on the last one,
+        then interpolates linearly between them
+    */
+    void applyShapeAtControlRate (SampleType* samples,
+                                  size_t numSamples,
+                                  SampleType morphStart,
+                                  SampleType morphStep) noexcept
+    {
+        const auto k = decimation;
+        const auto numGridNodes = (numSamples - 1) / k + 1;
+        auto* nodeValues = nodes.data();
+
+        for (size_t j = 0; j < numGridNodes; ++j)
+            nodeValues[j] = samples[j * k];
+        nodeValues[numGridNodes] = samples[numSamples - 1];
+
+        // The morph of the sample i is morphStart + morphStep * (i + 1)
+        applyShapeAtAudioRate (nodeValues, numGridNodes, morphStart + morphStep * (SampleType) (1 - (int) k), morphStep * (SampleType) k);
+        applyShapeAtAudioRate (nodeValues + numGridNodes, 1, morphStart + morphStep * (SampleType) (numSamples - 1), morphStep);
+
+        for (size_t j = 0; j < numGridNodes; ++j)
+        {
+            const auto begin = j * k;
+            const auto end = juce::jmin (begin + k, numSamples - 1);
+            const auto start = nodeValues[j];
+            const auto slope = end > begin ? (nodeValues[j + 1] - start) / (SampleType) (end - begin) : (SampleType) 0;
+            for (size_t i = 0; i < end - begin; ++i)
+                samples[begin + i] = start + slope * (SampleType) i;
+        }
+        samples[numSamples - 1] = nodeValues[numGridNodes];
+    }
+
+    /** Replaces a buffer of phases with the values of the current wave shape,
+        evaluated on every sample
+    */
+    void applyShapeAtAudioRate (SampleType* samples,
+                                size_t numSamples,
+                                SampleType morphStart,
+                                SampleType morphStep) noexcept
+    {
+        if (useLookup)
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+                samples[i] = waveShapeFunc (samples[i]);
+            return;
+        }
+
+        switch (waveShape)
+        {
+            case PhaseControlledOscillatorWaveShape::sine:
+                if (fastMath)
+                    applyShape<WaveShapes::FastSine<SampleType>> (samples, numSamples);
+                else
+                    applyShape<WaveShapes::Sine<SampleType>> (samples, numSamples);
+                break;
+            case PhaseControlledOscillatorWaveShape::sawtooth:
+                applyShape<WaveShapes::Sawtooth<SampleType>> (samples, numSamples);
+                break;
+            case PhaseControlledOscillatorWaveShape::wavetable:
+                applyWavetables (samples, numSamples, morphStart, morphStep);
+                break;
+        }
+    }
+
+    /** Replaces a buffer of phases with the corresponding wave shape values */
+    template <typename WaveShape>
+    static void applyShape (SampleType* samples, size_t numSamples) noexcept
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+            samples[i] = WaveShape::process (samples[i]);
+    }
+
+    /** Replaces a buffer of phases with the morph of the two wavetables.
+        The morph goes linearly from the start value by the given step per sample.
+    */
+    void applyWavetables (SampleType* samples,
+                          size_t numSamples,
+                          SampleType morphStart,
+                          SampleType morphStep) noexcept
+    {
+        if (wavetables == nullptr || wavetables->a == nullptr || wavetables->b == nullptr)
+        {
+            applyShape<WaveShapes::Sine<SampleType>> (samples, numSamples);
+            return;
+        }
+
+        const auto& a = *wavetables->a;
+        const auto& b = *wavetables->b;
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto u = WaveShapes::wrapToUnit (samples[i]);
+            const auto va = a.processUnit (u);
+            const auto m = morphStart + morphStep * (SampleType) (i + 1);
+            samples[i] = va + m * (b.processUnit (u) - va);
+        }
+    }
 
     //==============================================================================
-    const size_t lookup_size = 64;
+    // Built-in shapes are evaluated by compile-time policies (see WaveShapes.h),
+    // custom shape functions are approximated with a lookup table
+    PhaseControlledOscillatorWaveShape waveShape = PhaseControlledOscillatorWaveShape::sine;
+    bool useLookup = false, fastMath = false;
     juce::dsp::LookupTableTransform<SampleType> lookup;
 
+    // Wavetables are shared with other instances. The pair in use belongs to
+    // the processing thread, the pending and retired ones are exchanged
+    // with the setting thread (see swapPendingWavetables)
+    struct WavetablePair
+    {
+        typename Wavetable<SampleType>::Ptr a, b;
+    };
+    std::unique_ptr<WavetablePair> wavetables;
+    std::atomic<WavetablePair*> pendingWavetables { nullptr }, retiredWavetables { nullptr };
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> morph;
+
+    // Phase difference between channels
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> spread;
+    PhaseControlledOscillatorSpreadMode spreadMode = PhaseControlledOscillatorSpreadMode::all;
+
+    // Layout of the channels, and the fraction of the spread of each channel
+    // in the pairs mode (1 for the second channel of a pair, 0 otherwise)
+    juce::AudioChannelSet channelLayout;
+    std::vector<SampleType> pairWeights;
+
     SampleType sampleRate = 44100.0;
-    // Phase derivative (not frequency)
+    // Rate (in Hz) and its exact ratio
     SampleType rate = 1.0;
+    juce::uint32 rateNumerator = 1, rateDenominator = 1;
+
+    // Control-rate evaluation: spacing of the nodes and buffer of node values
+    bool controlRate = false;
+    size_t decimation = 1;
+    std::vector<SampleType> nodes;
 
     //==============================================================================
-    juce::dsp::Phase<SampleType> phase;
+    // Phase accumulator (2^64 steps per period) and its increment per sample
+    juce::uint64 phase = 0, increment = 0;
     juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> offset;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhaseControlledOscillator<SampleType>)
@@ -36,9 +36,9 @@ Tremolo<SampleType>::Tremolo()
 
 //==============================================================================
 template <typename SampleType>
-void Tremolo<SampleType>::setRate (SampleType newRateHz)
+void Tremolo<SampleType>::setRate (SampleType newRateHz, juce::uint32 numerator, juce::uint32 denominator)
 {
-    lfo.setRate (newRateHz);
+    lfo.setRate (newRateHz, numerator, denominator);
 }
 
 template <typename SampleType>
@@ -61,12 +61,96 @@ void Tremolo<SampleType>::setShape (
     std::function<SampleType (SampleType)> waveShapeFunc)
 {
     lfo.setShape (waveShapeFunc);
+    sineShape = false;
 }
 
 template <typename SampleType>
 void Tremolo<SampleType>::setShape (PhaseControlledOscillatorWaveShape waveShape)
 {
     lfo.setShape (waveShape);
+    sineShape = waveShape == PhaseControlledOscillatorWaveShape::sine;
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setControlRate (bool f)
+{
+    lfo.setControlRate (f);
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setFastMath (bool f)
+{
+    lfo.setFastMath (f);
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setOversampling (size_t order)
+{
+    order = juce::jmin (order, maxOversamplingOrder);
+    if (order != oversamplingOrder)
+    {
+        oversamplingOrder = order;
+        applyOversampling();
+    }
+}
+
+template <typename SampleType>
+int Tremolo<SampleType>::getLatencyInSamples() const noexcept
+{
+    return latencyInSamples.load (std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::applyOversampling() noexcept
+{
+    // Before prepare, there are no oversamplers yet
+    const auto index = oversamplingOrder - 1;
+    oversampler = oversamplingOrder > 0 ? oversamplers[index].get() : nullptr;
+    amOversampler = oversamplingOrder > 0 ? amOversamplers[index].get() : nullptr;
+    oversampling = false;
+
+    if (oversampler != nullptr)
+    {
+        oversampler->reset();
+        amOversampler->reset();
+    }
+
+    const auto latency = oversampler != nullptr ? (int) oversampler->getLatencyInSamples() : 0;
+    jassert (latency <= maxOversamplingLatency);
+    latencyInSamples.store (latency, std::memory_order_relaxed);
+    latencyDelay.reset();
+    latencyDelay.setDelay ((SampleType) latency);
+    dryWet.setWetLatency ((SampleType) latency);
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setWavetables (typename Wavetable<SampleType>::Ptr a, typename Wavetable<SampleType>::Ptr b)
+{
+    lfo.setWavetables (a, b);
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setMorph (SampleType newMorph)
+{
+    lfo.setMorph (newMorph);
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setSpread (SampleType newSpread)
+{
+    lfo.setSpread (newSpread);
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setSpreadMode (PhaseControlledOscillatorSpreadMode newSpreadMode)
+{
+    lfo.setSpreadMode (newSpreadMode);
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setChannelLayout (const juce::AudioChannelSet& newChannelLayout)
+{
+    lfo.setChannelLayout (newChannelLayout);
 }
 
 template <typename SampleType>
@@ -93,6 +177,12 @@ SampleType Tremolo<SampleType>::getOffset()
     return lfo.getOffset();
 }
 
+template <typename SampleType>
+void Tremolo<SampleType>::setDepthModulation (const SampleType* gains) noexcept
+{
+    depthGains = gains;
+}
+
 //==============================================================================
 template <typename SampleType>
 SampleType Tremolo<SampleType>::getPhase()
@@ -100,20 +190,71 @@ SampleType Tremolo<SampleType>::getPhase()
     return lfo.getPhase();
 }
 
+//==============================================================================
+template <typename SampleType>
+void Tremolo<SampleType>::setMetering (bool f)
+{
+    metering = f;
+}
+
+template <typename SampleType>
+SampleType Tremolo<SampleType>::getModulation() const noexcept
+{
+    return modulation;
+}
+
+template <typename SampleType>
+SampleType Tremolo<SampleType>::getLevel() const noexcept
+{
+    return level;
+}
+
 //==============================================================================
 template <typename SampleType>
 void Tremolo<SampleType>::prepare (const juce::dsp::ProcessSpec& spec)
 {
-    dryWet.prepare (spec);
-    lfo.prepare (spec);
-    amBuffer.reset (
-        new juce::AudioBuffer<SampleType> (
-            spec.numChannels, spec.maximumBlockSize));
+    const auto chunkSpec = chunkedSpec (spec);
+
+    // Re-preparing the mixer reallocates its delay line:
+    // skip it if the spec did not change
+    const auto sameSpec = isSameSpec (chunkSpec, preparedSpec);
+    if (sameSpec)
+        dryWet.reset();
+    else
+        dryWet.prepare (chunkSpec);
+    preparedSpec = chunkSpec;
 
-    amScale.prepare (spec);
-    amBias.prepare (spec);
+    lfo.prepare (chunkSpec);
+    if (amBuffer == nullptr)
+        amBuffer.reset (new juce::AudioBuffer<SampleType>());
+    // One modulator per channel, for the spread: a chunk of each, so that
+    // the spread can be enabled while processing without allocating
+    amBuffer->setSize ((int) chunkSpec.numChannels, (int) chunkSpec.maximumBlockSize, false, false, true);
+
+    amScale.prepare (chunkSpec);
+    amBias.prepare (chunkSpec);
     amScale.setRampDurationSeconds (rampLength);
     amBias.setRampDurationSeconds (rampLength);
+
+    // Oversampling of the AM, with an integer latency that is compensated
+    // in the dry signal and reproduced when the oversampling is skipped.
+    // The oversamplers of all orders are built (they are small, for a chunk),
+    // so that the order can change while processing. They are only rebuilt
+    // if the spec changed
+    if (! sameSpec || oversamplers[0] == nullptr)
+    {
+        const auto filterType = Oversampling::filterHalfBandPolyphaseIIR;
+        for (size_t i = 0; i < maxOversamplingOrder; ++i)
+        {
+            oversamplers[i].reset (new Oversampling (chunkSpec.numChannels, i + 1, filterType, true, true));
+            amOversamplers[i].reset (new Oversampling (chunkSpec.numChannels, i + 1, filterType, true, true));
+            oversamplers[i]->initProcessing (chunkSpec.maximumBlockSize);
+            amOversamplers[i]->initProcessing (chunkSpec.maximumBlockSize);
+        }
+    }
+
+    latencyDelay.prepare (chunkSpec);
+    applyOversampling();
 }
 
 template <typename SampleType>
@@ -122,7 +263,13 @@ void Tremolo<SampleType>::reset()
     lfo.reset();
     dryWet.reset();
     amScale.reset();
-    // amBias.reset();
+    amBias.reset();
+    latencyDelay.reset();
+    if (oversampler != nullptr)
+    {
+        oversampler->reset();
+        amOversampler->reset();
+    }
 }
 
 template <typename SampleType>
@@ -131,6 +278,37 @@ void Tremolo<SampleType>::advance (SampleType p)
     lfo.advance (p);
 }
 
+template <typename SampleType>
+void Tremolo<SampleType>::skip (juce::uint64 numSamples) noexcept
+{
+    lfo.skip (numSamples);
+}
+
+template <typename SampleType>
+juce::uint64 Tremolo<SampleType>::getPhaseAccumulator() const noexcept
+{
+    return lfo.getPhaseAccumulator();
+}
+
+template <typename SampleType>
+juce::uint64 Tremolo<SampleType>::getPhaseIncrement() const noexcept
+{
+    return lfo.getPhaseIncrement();
+}
+
+template <typename SampleType>
+void Tremolo<SampleType>::setPhaseAccumulator (juce::uint64 p) noexcept
+{
+    lfo.setPhaseAccumulator (p);
+}
+
+//==============================================================================
+template <typename SampleType>
+constexpr size_t Tremolo<SampleType>::maxOversamplingOrder;
+
+template <typename SampleType>
+constexpr int Tremolo<SampleType>::maxOversamplingLatency;
+
 //==============================================================================
 template class Tremolo<float>;
 template class Tremolo<double>;
@@ -28,6 +28,7 @@
 #pragma once
 
 #include "PhaseControlledOscillator.h"
+#include "Chunking.h"
 #include <JuceHeader.h>
 
 /**
@@ -50,8 +51,10 @@ public:
     Tremolo();
 
     //==============================================================================
-    /** Sets the rate (in Hz) of the modulant LFO. */
-    void setRate (SampleType newRateHz);
+    /** Sets the rate (in Hz) of the modulant LFO, scaled by an exact ratio
+        (see PhaseControlledOscillator::setRate).
+    */
+    void setRate (SampleType newRateHz, juce::uint32 numerator = 1, juce::uint32 denominator = 1);
 
     /** Sets the AM to be through zero or not. */
     void setThroughZero (bool);
@@ -62,6 +65,57 @@ public:
     /** Sets the shape of the modulant LFO. */
     void setShape (PhaseControlledOscillatorWaveShape waveShape);
 
+    /** Enables the control-rate evaluation of the modulant LFO
+        (see PhaseControlledOscillator::setControlRate).
+    */
+    void setControlRate (bool);
+
+    /** Enables the fast approximation of the sine shape of the modulant LFO
+        (see PhaseControlledOscillator::setFastMath).
+    */
+    void setFastMath (bool);
+
+    /** Sets the oversampling of the amplitude modulation, as a power of two
+        (0 for none, 1 for 2x, 2 for 4x).
+
+        The input and the modulators are upsampled with polyphase IIR
+        half-band filters, multiplied and downsampled, so that the sidebands
+        of sharp modulators do not alias. With the sine shape the product is
+        not oversampled, but it is delayed by the same latency.
+
+        The oversamplers of all orders are built by prepare, so the order can
+        be changed between chunks, on the processing thread. The latency
+        changes with it (see getLatencyInSamples).
+    */
+    void setOversampling (size_t);
+
+    /** Gets the latency (in samples) of the wet signal due to oversampling */
+    int getLatencyInSamples() const noexcept;
+
+    static constexpr size_t maxOversamplingOrder = 2;
+    static constexpr int maxOversamplingLatency = 64;
+
+    /** Sets the two wavetables of the modulant LFO, for the wavetable shape. */
+    void setWavetables (typename Wavetable<SampleType>::Ptr, typename Wavetable<SampleType>::Ptr);
+
+    /** Sets the morph between the two wavetables of the modulant LFO. */
+    void setMorph (SampleType);
+
+    /** Sets the phase difference (in radians) of the modulant LFO
+        between the first and the last channel.
+
+        Without spread, a single modulator is shared by all channels.
+    */
+    void setSpread (SampleType);
+
+    /** Sets how the phase spread is applied over the channels. */
+    void setSpreadMode (PhaseControlledOscillatorSpreadMode);
+
+    /** Sets the layout of the channels, for the pairs spread mode
+        (see PhaseControlledOscillator::setChannelLayout).
+    */
+    void setChannelLayout (const juce::AudioChannelSet&);
+
     /** Sets the amount of dry and wet signal in the output of the
         tremolo (between 0 for full dry and 1 for full wet).
     */
@@ -76,10 +130,28 @@ public:
     /** Gets the phase offset target value */
     SampleType getOffset();
 
+    /** Sets the gains of the depth for the next chunk, one per sample
+        (nullptr for none). The gains multiply the depth set by setMix.
+        The buffer must hold at least as many samples as the chunk.
+    */
+    void setDepthModulation (const SampleType* gains) noexcept;
+
     //==============================================================================
     /** Gets the current phase of the modulant LFO. */
     SampleType getPhase();
 
+    //==============================================================================
+    /** Enables the metering of the modulation and of the input level. */
+    void setMetering (bool);
+
+    /** Gets the last value of the modulation (of the first channel). */
+    SampleType getModulation() const noexcept;
+
+    /** Gets the peak level of the input (of the first channel)
+        in the last processed chunk.
+    */
+    SampleType getLevel() const noexcept;
+
     //==============================================================================
     /** Initialises the processor. */
     void prepare (const juce::dsp::ProcessSpec&);
@@ -90,10 +162,37 @@ public:
     /** Advances the modulant LFO by the given phase amount. */
     void advance (SampleType);
 
+    /** Advances the modulant LFO by a number of samples
+        (see PhaseControlledOscillator::skip).
+    */
+    void skip (juce::uint64 numSamples) noexcept;
+
+    /** Gets the phase accumulator of the modulant LFO
+        (see PhaseControlledOscillator::getPhaseAccumulator).
+    */
+    juce::uint64 getPhaseAccumulator() const noexcept;
+
+    /** Gets the increment per sample of the phase accumulator of the modulant LFO */
+    juce::uint64 getPhaseIncrement() const noexcept;
+
+    /** Sets the phase accumulator of the modulant LFO */
+    void setPhaseAccumulator (juce::uint64) noexcept;
+
     //==============================================================================
-    /** Processes the input and output samples supplied in the processing context. */
+    /** Processes the input and output samples supplied in the processing context.
+        The samples are processed in chunks of at most dspChunkSize samples.
+    */
     template <typename ProcessContext>
     void process (const ProcessContext& context) noexcept
+    {
+        forEachChunk (context, dspChunkSize, [this] (const auto& chunk) { processChunk (chunk); });
+    }
+
+private:
+    //==============================================================================
+    /** Processes a chunk of at most dspChunkSize samples. */
+    template <typename ProcessContext>
+    void processChunk (const ProcessContext& context) noexcept
     {
         const auto& inputBlock = context.getInputBlock();
         auto& outputBlock = context.getOutputBlock();
@@ -109,24 +208,127 @@ public:
 
         dryWet.pushDrySamples (inputBlock);
 
-        juce::dsp::AudioBlock<SampleType> amBlock (*amBuffer);
+        // Without spread, only the first modulator channel is rendered
+        const auto numSamples = outputBlock.getNumSamples();
+        const auto numModulators = lfo.hasSpread() ? outputBlock.getNumChannels() : 1;
+
+        auto amBlock = juce::dsp::AudioBlock<SampleType> (*amBuffer)
+                           .getSubsetChannelBlock (0, numModulators)
+                           .getSubBlock (0, numSamples);
+        jassert (amBlock.getNumSamples() == numSamples);
+
         juce::dsp::ProcessContextReplacing<SampleType> amPC (amBlock);
         lfo.process (amPC);
         amScale.process (amPC);
         amBias.process (amPC);
-        outputBlock.replaceWithProductOf (inputBlock, amBlock);
+
+        // Depth per sample, as the dry/wet mix does: x (1 + g (am - 1))
+        if (depthGains != nullptr)
+        {
+            for (size_t channel = 0; channel < numModulators; ++channel)
+            {
+                auto* am = amBlock.getChannelPointer (channel);
+                juce::FloatVectorOperations::add (am, (SampleType) -1, (int) numSamples);
+                juce::FloatVectorOperations::multiply (am, depthGains, (int) numSamples);
+                juce::FloatVectorOperations::add (am, (SampleType) 1, (int) numSamples);
+            }
+        }
+
+        // The sine is smooth enough not to alias: skip the oversampling,
+        // but keep the same latency
+        const auto oversample = oversampler != nullptr && ! sineShape;
+        if (oversample != oversampling)
+        {
+            oversampling = oversample;
+            if (oversampling)
+            {
+                oversampler->reset();
+                amOversampler->reset();
+            }
+            else
+            {
+                latencyDelay.reset();
+            }
+        }
+
+        if (oversampling)
+        {
+            // The oversampler of the modulators returns all of its channels:
+            // keep the ones that were upsampled (one without spread)
+            auto upBlock = oversampler->processSamplesUp (inputBlock);
+            const auto upAmBlock = amOversampler->processSamplesUp (amBlock)
+                                       .getSubsetChannelBlock (0, amBlock.getNumChannels());
+            modulate (upBlock, upBlock, upAmBlock);
+            oversampler->processSamplesDown (outputBlock);
+        }
+        else
+        {
+            modulate (outputBlock, inputBlock, amBlock);
+            if (oversampler != nullptr)
+                latencyDelay.process (juce::dsp::ProcessContextReplacing<SampleType> (outputBlock));
+        }
+
+        if (metering)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax (inputBlock.getChannelPointer (0), (int) numSamples);
+            level = juce::jmax (-range.getStart(), range.getEnd());
+            modulation = amBlock.getSample (0, (int) numSamples - 1);
+        }
 
         dryWet.mixWetSamples (outputBlock);
     }
 
-private:
+    /** Switches to the oversamplers of the current order, and
+        updates the latency of the dry signal
+    */
+    void applyOversampling() noexcept;
+
+    /** Multiplies the input by the modulators: one per channel, or a
+        single one shared by all channels
+    */
+    template <typename InputBlock>
+    static void modulate (juce::dsp::AudioBlock<SampleType>& outputBlock,
+                          const InputBlock& inputBlock,
+                          const juce::dsp::AudioBlock<SampleType>& amBlock) noexcept
+    {
+        if (amBlock.getNumChannels() == 1)
+        {
+            const auto* am = amBlock.getChannelPointer (0);
+            for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
+                juce::FloatVectorOperations::multiply (outputBlock.getChannelPointer (channel),
+                                                       inputBlock.getChannelPointer (channel),
+                                                       am,
+                                                       (int) outputBlock.getNumSamples());
+        }
+        else
+        {
+            outputBlock.replaceWithProductOf (inputBlock, amBlock);
+        }
+    }
+
     //==============================================================================
-    juce::dsp::DryWetMixer<SampleType> dryWet;
+    juce::dsp::DryWetMixer<SampleType> dryWet { maxOversamplingLatency };
     juce::dsp::Gain<SampleType> amScale;
     juce::dsp::Bias<SampleType> amBias;
     PhaseControlledOscillator<SampleType> lfo;
     std::unique_ptr<juce::AudioBuffer<SampleType>> amBuffer;
+    const SampleType* depthGains = nullptr;
+    juce::dsp::ProcessSpec preparedSpec {};
     SampleType rampLength = static_cast<SampleType> (0.005);
+    bool metering = false;
+    SampleType modulation = 0, level = 0;
+
+    //==============================================================================
+    // One pair of oversamplers (input and modulators) per order,
+    // and the pair of the current order (none without oversampling)
+    using Oversampling = juce::dsp::Oversampling<SampleType>;
+    size_t oversamplingOrder = 0;
+    std::array<std::unique_ptr<Oversampling>, maxOversamplingOrder> oversamplers, amOversamplers;
+    Oversampling* oversampler = nullptr;
+    Oversampling* amOversampler = nullptr;
+    std::atomic<int> latencyInSamples { 0 };
+    juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::None> latencyDelay { maxOversamplingLatency };
+    bool sineShape = true, oversampling = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Tremolo<SampleType>)
 };
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    WaveShapes.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Compile-time wave shape policies for the built-in oscillator shapes.
+
+    Each policy maps a phase (in radians, any value) to an output between
+    0 and 1. The functions are branch-free so that the compiler can inline
+    them and vectorize the loops that call them.
+
+    @tags{DSP}
+*/
+namespace WaveShapes
+{
+/** Wraps a phase (in radians) to a fraction of period in [0, 1) */
+template <typename SampleType>
+inline SampleType wrapToUnit (SampleType phase) noexcept
+{
+    const auto u = phase * (((SampleType) 1) / juce::MathConstants<SampleType>::twoPi);
+    return u - std::floor (u);
+}
+
+/** Raised sine: (sin (phase) + 1) / 2
+
+    The sine is folded to [-pi/2, pi/2] and evaluated with a polynomial
+    (Taylor series up to the 11th order). The maximum error with respect
+    to std::sin is below 3e-8 in the output range.
+*/
+template <typename SampleType>
+struct Sine
+{
+    static inline SampleType process (SampleType phase) noexcept
+    {
+        // sin (2 pi u) = -sin (2 pi v), with v in [-1/2, 1/2)
+        const auto v = wrapToUnit (phase) - (SampleType) 0.5;
+
+        // Fold v to [-1/4, 1/4], where the polynomial is accurate
+        const auto q = (SampleType) 0.25;
+        const auto w = std::copysign (q - std::abs (q - std::abs (v)), v);
+
+        const auto x = juce::MathConstants<SampleType>::twoPi * w;
+        const auto x2 = x * x;
+        const auto s = x * ((SampleType) 1 + x2 * ((SampleType) (-1.0 / 6.0) + x2 * ((SampleType) (1.0 / 120.0) + x2 * ((SampleType) (-1.0 / 5040.0) + x2 * ((SampleType) (1.0 / 362880.0) + x2 * (SampleType) (-1.0 / 39916800.0))))));
+
+        return ((SampleType) 1 - s) / (SampleType) 2;
+    }
+};
+
+/** Raised sine, fast approximation: (sin (phase) + 1) / 2
+
+    Same folding as Sine, with a 5th order minimax polynomial instead of
+    the Taylor series. The maximum error with respect to std::sin is below
+    7e-5 before raising, i.e. below 3.5e-5 in the output range (-89 dB).
+*/
+template <typename SampleType>
+struct FastSine
+{
+    static inline SampleType process (SampleType phase) noexcept
+    {
+        const auto v = wrapToUnit (phase) - (SampleType) 0.5;
+        const auto q = (SampleType) 0.25;
+        const auto w = std::copysign (q - std::abs (q - std::abs (v)), v);
+
+        const auto x = juce::MathConstants<SampleType>::twoPi * w;
+        const auto x2 = x * x;
+        const auto s = x * ((SampleType) 0.99969677 + x2 * ((SampleType) (-0.16567308) + x2 * (SampleType) 0.0075143772));
+
+        return ((SampleType) 1 - s) / (SampleType) 2;
+    }
+};
+
+/** Rising sawtooth: phase / (2 pi), wrapped to [0, 1)
+
+    The wrap is exact, so there is no interpolation smear at the
+    discontinuity.
+*/
+template <typename SampleType>
+struct Sawtooth
+{
+    static inline SampleType process (SampleType phase) noexcept
+    {
+        return wrapToUnit (phase);
+    }
+};
+} // namespace WaveShapes
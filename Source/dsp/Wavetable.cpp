@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    Wavetable.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "Wavetable.h"
+
+//==============================================================================
+template <typename SampleType>
+Wavetable<SampleType>::Wavetable (const SampleType* newValues, size_t size)
+    : values (newValues, newValues + size),
+      slopes (size),
+      scale ((SampleType) size),
+      last (size - 1)
+{
+    for (size_t i = 0; i < size; ++i)
+        slopes[i] = values[(i + 1) % size] - values[i];
+}
+
+//==============================================================================
+template <typename SampleType>
+typename Wavetable<SampleType>::Ptr Wavetable<SampleType>::create (const SampleType* values, size_t size)
+{
+    jassert (size > 0);
+
+    // Pool of the tables in use, indexed by content hash
+    static juce::CriticalSection poolLock;
+    static std::multimap<juce::uint64, std::weak_ptr<const Wavetable<SampleType>>> pool;
+
+    // FNV-1a hash of the table values
+    juce::uint64 hash = 14695981039346656037ull;
+    const auto* bytes = reinterpret_cast<const juce::uint8*> (values);
+    for (size_t i = 0; i < size * sizeof (SampleType); ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+    const juce::ScopedLock lock (poolLock);
+    auto range = pool.equal_range (hash);
+    for (auto it = range.first; it != range.second;)
+    {
+        if (auto table = it->second.lock())
+        {
+            if (table->getSize() == size && std::equal (values, values + size, table->getValues()))
+                return table;
+            ++it;
+        }
+        else
+        {
+            it = pool.erase (it);
+        }
+    }
+
+    Ptr table (new Wavetable<SampleType> (values, size));
+    pool.emplace (hash, table);
+    return table;
+}
+
+template <typename SampleType>
+typename Wavetable<SampleType>::Ptr Wavetable<SampleType>::fromFunction (const std::function<SampleType (SampleType)>& f, size_t size)
+{
+    std::vector<SampleType> v (size);
+    for (size_t i = 0; i < size; ++i)
+        v[i] = f (juce::MathConstants<SampleType>::twoPi * (SampleType) i / (SampleType) size);
+    return create (v.data(), size);
+}
+
+//==============================================================================
+template class Wavetable<float>;
+template class Wavetable<double>;
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    Wavetable.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "WaveShapes.h"
+#include <JuceHeader.h>
+
+/**
+    A read-only, single-period wavetable for LFOs.
+
+    The table stores its values together with the precomputed slopes
+    between consecutive points, so that a linearly interpolated lookup is
+    one multiply-add. Tables are immutable and handed out as shared
+    pointers: instances which use the same shape share the same memory.
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class Wavetable
+{
+public:
+    //==============================================================================
+    using Ptr = std::shared_ptr<const Wavetable<SampleType>>;
+
+    /** Default number of points for a table */
+    static constexpr size_t defaultSize = 256;
+
+    //==============================================================================
+    /** Gets a table with the given values (one period, starting at phase 0).
+        If a table with the same values already exists, that one is returned.
+    */
+    static Ptr create (const SampleType* values, size_t size);
+
+    /** Gets a table by sampling a wave shape function over one period. */
+    static Ptr fromFunction (const std::function<SampleType (SampleType)>&, size_t size = defaultSize);
+
+    /** Gets a table by sampling a wave shape policy over one period. */
+    template <typename WaveShape>
+    static Ptr fromShape (size_t size = defaultSize)
+    {
+        return fromFunction (WaveShape::process, size);
+    }
+
+    //==============================================================================
+    /** Gets the number of points in the table */
+    size_t getSize() const noexcept { return values.size(); }
+
+    /** Gets the table values */
+    const SampleType* getValues() const noexcept { return values.data(); }
+
+    /** Reads the table at a fraction of period in [0, 1) with linear interpolation */
+    SampleType processUnit (SampleType u) const noexcept
+    {
+        const auto x = u * scale;
+        const auto i = juce::jmin ((size_t) x, last);
+        return values[i] + slopes[i] * (x - (SampleType) i);
+    }
+
+private:
+    //==============================================================================
+    Wavetable (const SampleType* values, size_t size);
+
+    //==============================================================================
+    std::vector<SampleType> values, slopes;
+    SampleType scale;
+    size_t last;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Wavetable<SampleType>)
+};
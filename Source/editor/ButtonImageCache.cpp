@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    ButtonImageCache.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "ButtonImageCache.h"
+#include "ToggleWrapper.h"
+
+//==============================================================================
+ButtonImageCache::ButtonImageCache()
+{
+}
+
+juce::Image ButtonImageCache::getImage (Shape shape,
+                                        juce::Colour colour,
+                                        int width,
+                                        int height,
+                                        float thickness,
+                                        float scale)
+{
+    const Key key { (int) shape, colour.getARGB(), width, height, thickness, scale };
+
+    const juce::ScopedLock sl (lock);
+    auto it = images.find (key);
+    if (it != images.end())
+        return it->second;
+
+    auto path = shape == throughZero
+                    ? throughZeroPath ((float) width, (float) height, thickness)
+                    : smallCirclePath ((float) width, (float) height, thickness);
+    path.applyTransform (juce::AffineTransform::scale (scale));
+
+    juce::Image img (juce::Image::ARGB,
+                     juce::roundToInt ((float) width * scale),
+                     juce::roundToInt ((float) height * scale),
+                     true);
+    {
+        juce::Graphics g (img);
+        g.setColour (colour);
+        g.fillPath (path);
+    }
+
+    images.emplace (key, img);
+    return img;
+}
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    ButtonImageCache.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Process-wide cache of the rendered button images.
+
+    Use it through a juce::SharedResourcePointer: the cache is shared by all
+    the editors and released when the last one is closed. Images are
+    rendered on the first request and keyed by shape, colour, size,
+    thickness and scale, so editors with the same look share the same
+    pixel data.
+*/
+class ButtonImageCache
+{
+public:
+    //==============================================================================
+    enum Shape
+    {
+        throughZero,
+        smallCircle
+    };
+
+    //==============================================================================
+    ButtonImageCache();
+
+    /** Gets the image of a shape (see throughZeroPath and smallCirclePath).
+        The size is in logical pixels: the image is rendered from the vector
+        path with (size * scale) physical pixels.
+    */
+    juce::Image getImage (Shape shape,
+                          juce::Colour colour,
+                          int width,
+                          int height,
+                          float thickness,
+                          float scale = 1.0f);
+
+private:
+    //==============================================================================
+    using Key = std::tuple<int, juce::uint32, int, int, float, float>;
+
+    juce::CriticalSection lock;
+    std::map<Key, juce::Image> images;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ButtonImageCache)
+};
@@ -42,25 +42,13 @@ HyperTremoloPluginEditor::HyperTremoloPluginEditor (HyperTremoloPlugin& p,
       xoverMixKnob ("xoverMix"),
       tremZeroToggle ("tremZero"),
       tremSyncButton ("tremSync"),
+      scope (p.getTelemetry()),
+      spectrum (p.getAnalyzer()),
       valueTreeState (vts)
 {
-    // Set up button images
-    auto offColour = getLookAndFeel().findColour (juce::Slider::ColourIds::rotarySliderFillColourId);
-    auto onColour = getLookAndFeel().findColour (juce::Slider::ColourIds::thumbColourId);
-    auto imgWidth = knobWidth - knobLabelHeight - knobMatrixColSep;
-    float lineThick = 8.0f;
-    auto onImg = throughZeroImage (onColour, imgWidth, imgWidth, lineThick);
-    auto offImg = throughZeroImage (offColour, imgWidth, imgWidth, lineThick);
-
-    tremZeroToggle.setImages (
-        true, false, true, offImg, 1.0f, {}, onImg, 0.333f, {}, onImg, 1.0f, {}, 0.9f);
-
-    lineThick *= 0.75f;
-    onImg = smallCircleImage (onColour, imgWidth, imgWidth, lineThick);
-    offImg = smallCircleImage (offColour, imgWidth, imgWidth, lineThick);
-
-    tremSyncButton.setImages (
-        true, false, true, offImg, 1.0f, {}, onImg, 0.333f, {}, onImg, 1.0f, {}, 0.9f);
+    // Set up button images (shared by all editors)
+    updateButtonImages();
+    startTimerHz (scaleCheckRateHz);
     addAndMakeVisible (tooltipWindow);
     tremSyncButton.setTooltip ("Sync the two tremolos. Click\nthis when setting ratio to 1");
     tremSyncButton.setOnStateChange();
@@ -87,6 +75,8 @@ HyperTremoloPluginEditor::HyperTremoloPluginEditor (HyperTremoloPlugin& p,
 
     addAndMakeVisible (footerLeftLabel);
     addAndMakeVisible (footerRightLabel);
+    addAndMakeVisible (scope);
+    addAndMakeVisible (spectrum);
 
     // Apply controls to the editor
     mixKnob.applyTo (*this, valueTreeState, knobWidth, knobLabelHeight);
@@ -101,7 +91,44 @@ HyperTremoloPluginEditor::HyperTremoloPluginEditor (HyperTremoloPlugin& p,
     xoverBalanceKnob.applyTo (*this, valueTreeState, knobWidth, knobLabelHeight);
     xoverMixKnob.applyTo (*this, valueTreeState, knobWidth, knobLabelHeight);
 
-    setSize(knobMatrixWidth, knobMatrixHeight + footerHeight);
+    setSize(knobMatrixWidth, knobMatrixHeight + scopeHeight + knobGroupRowSep + footerHeight);
+}
+
+//==============================================================================
+void HyperTremoloPluginEditor::updateButtonImages()
+{
+    // The images have as many pixels as the display shows for the buttons,
+    // and are drawn at their logical size
+    const auto scale = juce::Component::getApproximateScaleFactorForComponent (this);
+    if (scale == buttonImageScale)
+        return;
+    buttonImageScale = scale;
+
+    auto offColour = getLookAndFeel().findColour (juce::Slider::ColourIds::rotarySliderFillColourId);
+    auto onColour = getLookAndFeel().findColour (juce::Slider::ColourIds::thumbColourId);
+    auto imgWidth = knobWidth - knobLabelHeight - knobMatrixColSep;
+    float lineThick = 8.0f;
+    auto onImg = imageCache->getImage (ButtonImageCache::throughZero, onColour, imgWidth, imgWidth, lineThick, scale);
+    auto offImg = imageCache->getImage (ButtonImageCache::throughZero, offColour, imgWidth, imgWidth, lineThick, scale);
+
+    tremZeroToggle.setImages (
+        false, true, true, offImg, 1.0f, {}, onImg, 0.333f, {}, onImg, 1.0f, {}, 0.9f, scale);
+
+    lineThick *= 0.75f;
+    onImg = imageCache->getImage (ButtonImageCache::smallCircle, onColour, imgWidth, imgWidth, lineThick, scale);
+    offImg = imageCache->getImage (ButtonImageCache::smallCircle, offColour, imgWidth, imgWidth, lineThick, scale);
+
+    tremSyncButton.setImages (
+        false, true, true, offImg, 1.0f, {}, onImg, 0.333f, {}, onImg, 1.0f, {}, 0.9f, scale);
+
+    // Lay out the buttons for the new images
+    if (! getLocalBounds().isEmpty())
+        resized();
+}
+
+void HyperTremoloPluginEditor::timerCallback()
+{
+    updateButtonImages();
 }
 
 //==============================================================================
@@ -127,6 +154,7 @@ void HyperTremoloPluginEditor::paint (juce::Graphics& g)
     drawRoundedRectangleHelper (g, mixRect, 15.0f, 2.0f);
     drawRoundedRectangleHelper (g, tremRect, 15.0f, 2.0f);
     drawRoundedRectangleHelper (g, xoverRect, 15.0f, 2.0f);
+    drawRoundedRectangleHelper (g, scopeRect, 15.0f, 2.0f);
 }
 
 template <typename ValueType>
@@ -145,6 +173,8 @@ void HyperTremoloPluginEditor::resized()
     // Group rectangles
     rectTrimHelper (rect, knobGroupColSep, knobGroupRowSep);
     footerRect = rect.removeFromBottom (footerHeight);
+    scopeRect = rect.removeFromBottom (scopeHeight);
+    rect.removeFromBottom (knobGroupRowSep);
     mixRect = rect.removeFromRight (knobWidth + knobMatrixColSep);
     rect.removeFromRight (knobGroupColSep);
     tremRect = rect.removeFromTop (knobHeight + knobLabelHeight + 2 * knobMatrixRowSep);
@@ -157,6 +187,11 @@ void HyperTremoloPluginEditor::resized()
     footerLeftLabel.setBounds (footerRectConsumable.removeFromLeft (footerRectConsumable.getWidth() / 3));
     footerRightLabel.setBounds (footerRectConsumable.removeFromRight (footerRectConsumable.getWidth()));
 
+    // Scope and spectrum
+    auto scopeArea = scopeRect.reduced (8, 2);
+    spectrum.setBounds (scopeArea.removeFromRight (scopeArea.getWidth() / 2));
+    scope.setBounds (scopeArea);
+
     // Mixer
     juce::Rectangle<int> mixRectConsumable (mixRect);
     rectTrimHelper (mixRectConsumable, knobMatrixColSep, knobMatrixRowSep);
@@ -28,15 +28,19 @@
 #pragma once
 
 #include "../processor/Plugin.h"
+#include "ButtonImageCache.h"
 #include "ToggleWrapper.h"
 #include "KnobWrapper.h"
+#include "ModulationScope.h"
+#include "SpectrumView.h"
 #include <JuceHeader.h>
 
 //==============================================================================
 /**
     Editor for the HyperTremolo plugin
 */
-class HyperTremoloPluginEditor  : public juce::AudioProcessorEditor
+class HyperTremoloPluginEditor  : public juce::AudioProcessorEditor,
+                                  private juce::Timer
 {
 public:
     HyperTremoloPluginEditor (HyperTremoloPlugin&,
@@ -48,13 +52,21 @@ public:
 
 private:
     //==============================================================================
+    /** Renders the button images for the display scale, if it changed */
+    void updateButtonImages();
+
+    /** Follows the display scale, e.g. when the window moves to another screen */
+    void timerCallback() override;
+
+    //==============================================================================
+    static const int scaleCheckRateHz = 2;
     static const int knobMatrixCols = 5, knobMatrixRows = 2,
                      knobMatrixRowSep = 3, knobMatrixColSep = 2,
                      knobWidth = 78, knobLabelHeight = 13,
                      knobHeight = knobWidth + knobLabelHeight,
                      nRowGroups = 2, nColGroups = 2, 
                      knobGroupRowSep = 2, knobGroupColSep = 2,
-                     footerHeight = 12,
+                     footerHeight = 12, scopeHeight = 64,
                      knobMatrixHeight = knobMatrixRows * (knobHeight + knobLabelHeight + 2 * knobMatrixRowSep) + (nRowGroups + 1) * knobGroupRowSep,
                      knobMatrixWidth = knobMatrixCols * (knobWidth + 2 * knobMatrixColSep) + (nColGroups + 1) * knobGroupColSep;
 
@@ -62,8 +74,12 @@ private:
     KnobWrapper mixKnob, gainKnob, tremRateKnob, tremRatioKnob, tremMixKnob,
         xoverFreqKnob, xoverResonKnob, xoverBalanceKnob, xoverMixKnob;
     ToggleWrapper tremZeroToggle, tremSyncButton;
+    juce::SharedResourcePointer<ButtonImageCache> imageCache;
+    float buttonImageScale = 0.0f;
+    ModulationScope scope;
+    SpectrumView spectrum;
     juce::TooltipWindow tooltipWindow;
-    juce::Rectangle<int> tremRect, xoverRect, mixRect, footerRect;
+    juce::Rectangle<int> tremRect, xoverRect, mixRect, scopeRect, footerRect;
     juce::Label footerLeftLabel, footerRightLabel;
     juce::String footerLeftString, footerRightString;
 
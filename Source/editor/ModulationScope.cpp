@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    ModulationScope.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "ModulationScope.h"
+
+//==============================================================================
+ModulationScope::ModulationScope (ModulationTelemetry& t)
+    : telemetry (t)
+{
+    history.fill ({ { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f });
+    setInterceptsMouseClicks (false, false);
+    telemetry.setEnabled (true);
+    startTimerHz (refreshRateHz);
+}
+
+ModulationScope::~ModulationScope()
+{
+    stopTimer();
+    telemetry.setEnabled (false);
+}
+
+//==============================================================================
+void ModulationScope::timerCallback()
+{
+    const auto n = telemetry.pop (incoming.data(), (int) incoming.size());
+    if (n == 0)
+        return;
+
+    for (int i = 0; i < n; ++i)
+    {
+        history[(size_t) writeIndex] = incoming[(size_t) i];
+        writeIndex = (writeIndex + 1) % numPoints;
+    }
+    repaint();
+}
+
+void ModulationScope::paint (juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat().reduced (4.0f);
+    const auto onColour = getLookAndFeel().findColour (juce::Slider::ColourIds::thumbColourId);
+    const auto offColour = getLookAndFeel().findColour (juce::Slider::ColourIds::rotarySliderFillColourId);
+    const auto textColour = getLookAndFeel().findColour (juce::Label::ColourIds::textColourId);
+    const auto& last = history[(size_t) ((writeIndex + numPoints - 1) % numPoints)];
+
+    // Band levels, on the right
+    const auto meterWidth = 6.0f;
+    auto meters = bounds.removeFromRight (2.0f * meterWidth + 2.0f);
+    bounds.removeFromRight (4.0f);
+    for (int band = 0; band < 2; ++band)
+    {
+        auto meter = meters.removeFromLeft (meterWidth);
+        meters.removeFromLeft (2.0f);
+        g.setColour (offColour);
+        g.fillRect (meter);
+        g.setColour (band == 0 ? onColour : textColour);
+        g.fillRect (meter.removeFromBottom (meter.getHeight() * juce::jlimit (0.0f, 1.0f, last.level[band])));
+    }
+
+    // Modulators, from the oldest to the newest frame, between -1 and +1
+    const auto dx = bounds.getWidth() / (float) (numPoints - 1);
+    for (int band = 0; band < 2; ++band)
+    {
+        juce::Path path;
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto& frame = history[(size_t) ((writeIndex + i) % numPoints)];
+            const auto x = bounds.getX() + dx * (float) i;
+            const auto y = bounds.getCentreY() - 0.5f * bounds.getHeight() * juce::jlimit (-1.0f, 1.0f, frame.modulation[band]);
+            if (i == 0)
+                path.startNewSubPath (x, y);
+            else
+                path.lineTo (x, y);
+        }
+        g.setColour (band == 0 ? onColour : textColour);
+        g.strokePath (path, juce::PathStrokeType (1.5f));
+    }
+
+    // Phase difference
+    g.setColour (textColour);
+    g.setFont (11.0f);
+    g.drawText (juce::String (juce::radiansToDegrees (last.phaseDifference), 0) + juce::String (juce::CharPointer_UTF8 ("\xc2\xb0")),
+                bounds.removeFromTop (12.0f).removeFromLeft (40.0f),
+                juce::Justification::topLeft);
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    ModulationScope.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../processor/ModulationTelemetry.h"
+#include <JuceHeader.h>
+
+/**
+    Scope of the two tremolo modulators, their band levels and their
+    phase difference, fed by the modulation telemetry of the processor.
+
+    The telemetry feed is enabled while the scope exists, and it is drained
+    on a timer at a throttled refresh rate.
+*/
+class ModulationScope  : public juce::Component,
+                         private juce::Timer
+{
+public:
+    //==============================================================================
+    ModulationScope (ModulationTelemetry&);
+    ~ModulationScope() override;
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+
+    //==============================================================================
+    static const int numPoints = 256, refreshRateHz = 30;
+
+    ModulationTelemetry& telemetry;
+    std::array<ModulationTelemetry::Frame, ModulationTelemetry::capacity> incoming;
+    std::array<ModulationTelemetry::Frame, numPoints> history;
+    int writeIndex = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModulationScope)
+};
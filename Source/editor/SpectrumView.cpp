@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    SpectrumView.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "SpectrumView.h"
+
+//==============================================================================
+SpectrumView::SpectrumView (BandAnalyzer& a)
+    : analyzer (a)
+{
+    for (auto& s : spectra)
+        s.fill (0.0f);
+    setInterceptsMouseClicks (false, false);
+    analyzer.setEnabled (true);
+    worker->addAnalyzer (&analyzer);
+    startTimerHz (refreshRateHz);
+}
+
+SpectrumView::~SpectrumView()
+{
+    stopTimer();
+    worker->removeAnalyzer (&analyzer);
+    analyzer.setEnabled (false);
+}
+
+//==============================================================================
+void SpectrumView::timerCallback()
+{
+    if (! analyzer.getSpectrum (spectra[0].data(), spectra[1].data()))
+        return;
+
+    // Repaint the union of the areas of the old and the new curves
+    auto dirty = paths[0].getBounds().getUnion (paths[1].getBounds());
+    updatePaths();
+    dirty = dirty.getUnion (paths[0].getBounds()).getUnion (paths[1].getBounds());
+    repaint (dirty.getSmallestIntegerContainer().expanded (2));
+}
+
+void SpectrumView::updatePaths()
+{
+    const auto bounds = getLocalBounds().toFloat().reduced (4.0f);
+    const auto dx = bounds.getWidth() / (float) (BandAnalyzer::numPoints - 1);
+
+    for (size_t band = 0; band < paths.size(); ++band)
+    {
+        auto& path = paths[band];
+        path.clear();
+        for (int i = 0; i < BandAnalyzer::numPoints; ++i)
+        {
+            const auto x = bounds.getX() + dx * (float) i;
+            const auto y = bounds.getBottom() - bounds.getHeight() * juce::jlimit (0.0f, 1.0f, spectra[band][(size_t) i]);
+            if (i == 0)
+                path.startNewSubPath (x, y);
+            else
+                path.lineTo (x, y);
+        }
+    }
+}
+
+void SpectrumView::resized()
+{
+    const auto bounds = getLocalBounds().toFloat().reduced (4.0f);
+    const auto gridColour = getLookAndFeel().findColour (juce::Slider::ColourIds::rotarySliderFillColourId);
+
+    // Decades of the logarithmic frequency axis
+    grid = juce::Image (juce::Image::ARGB, juce::jmax (1, getWidth()), juce::jmax (1, getHeight()), true);
+    juce::Graphics g (grid);
+    g.setColour (gridColour);
+    const auto numDecades = std::log10 (BandAnalyzer::maxFrequency / BandAnalyzer::minFrequency);
+    for (auto frequency = 100.0f; frequency < BandAnalyzer::maxFrequency; frequency *= 10.0f)
+    {
+        const auto x = bounds.getX() + bounds.getWidth() * std::log10 (frequency / BandAnalyzer::minFrequency) / numDecades;
+        g.drawVerticalLine (juce::roundToInt (x), bounds.getY(), bounds.getBottom());
+    }
+
+    updatePaths();
+}
+
+void SpectrumView::paint (juce::Graphics& g)
+{
+    const auto onColour = getLookAndFeel().findColour (juce::Slider::ColourIds::thumbColourId);
+    const auto textColour = getLookAndFeel().findColour (juce::Label::ColourIds::textColourId);
+
+    g.drawImageAt (grid, 0, 0);
+    for (size_t band = 0; band < paths.size(); ++band)
+    {
+        g.setColour (band == 0 ? onColour : textColour);
+        g.strokePath (paths[band], juce::PathStrokeType (1.5f));
+    }
+}
@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    SpectrumView.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../processor/BandAnalyzer.h"
+#include <JuceHeader.h>
+
+/**
+    Spectra of the two crossover bands, computed by the band analyzer of
+    the processor on the shared background thread.
+
+    The analyzer is enabled while the view exists. The frequency grid is
+    rendered once per size into a cached image, and only the region covered
+    by the old and the new curves is repainted when a spectrum arrives.
+*/
+class SpectrumView  : public juce::Component,
+                      private juce::Timer
+{
+public:
+    //==============================================================================
+    SpectrumView (BandAnalyzer&);
+    ~SpectrumView() override;
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+
+    /** Rebuilds the curves from the current spectra */
+    void updatePaths();
+
+    //==============================================================================
+    static const int refreshRateHz = 30;
+
+    BandAnalyzer& analyzer;
+    juce::SharedResourcePointer<BandAnalyzerThread> worker;
+    std::array<std::array<float, BandAnalyzer::numPoints>, BandAnalyzer::numBands> spectra;
+    std::array<juce::Path, BandAnalyzer::numBands> paths;
+    juce::Image grid;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumView)
+};
@@ -28,6 +28,43 @@
 #include "ToggleWrapper.h"
 
 //==============================================================================
+juce::Path throughZeroPath (
+    float width,
+    float height,
+    float thickness,
+    int nCircles)
+{
+    juce::Path outline;
+    for (int i = 0; i < nCircles; ++i)
+    {
+        float iThick = thickness / (i + 1.0f),
+              effectiveWidth = width - iThick, effectiveHeight = height - iThick,
+              w = effectiveWidth / (i + 1.0f), h = effectiveHeight / (i + 1.0f),
+              hpad = (width - w) / 2.0f, vpad = (width - h) / 2.0f;
+
+        juce::Path ellipse;
+        ellipse.addEllipse (hpad, vpad, w, h);
+        juce::Path stroke;
+        juce::PathStrokeType (iThick).createStrokedPath (stroke, ellipse);
+        outline.addPath (stroke);
+    }
+    return outline;
+}
+
+juce::Path smallCirclePath (
+    float width,
+    float height,
+    float radius)
+{
+    juce::Path circle;
+    circle.addEllipse (
+        width / 2.0f - radius,
+        height / 2.0f - radius,
+        2 * radius,
+        2 * radius);
+    return circle;
+}
+
 juce::Image throughZeroImage (
     juce::Colour colour,
     int imageWidth,
@@ -41,14 +78,7 @@ juce::Image throughZeroImage (
     juce::Graphics g (img);
 
     g.setColour (colour);
-    for (int i = 0; i < nCircles; ++i)
-    {
-        float iThick = thickness / (i + 1.0f),
-              effectiveWidth = imageWidth - iThick, effectiveHeight = imageHeight - iThick,
-              width = effectiveWidth / (i + 1.0f), height = effectiveHeight / (i + 1.0f),
-              hpad = (imageWidth - width) / 2.0f, vpad = (imageWidth - height) / 2.0f;
-        g.drawEllipse (hpad, vpad, width, height, iThick);
-    }
+    g.fillPath (throughZeroPath ((float) imageWidth, (float) imageHeight, thickness, nCircles));
 
     return img;
 }
@@ -65,11 +95,7 @@ juce::Image smallCircleImage (
     juce::Graphics g (img);
 
     g.setColour (colour);
-    g.fillEllipse (
-        imageWidth / 2.0f - radius,
-        imageHeight / 2.0f - radius,
-        2 * radius,
-        2 * radius);
+    g.fillPath (smallCirclePath ((float) imageWidth, (float) imageHeight, radius));
 
     return img;
 }
@@ -104,17 +130,17 @@ void ToggleWrapper::setBounds (juce::Rectangle<int> newBounds)
     newBounds.removeFromBottom (labelHeight / 2);
     label.setBounds (newBounds.removeFromBottom (labelHeight));
 
-    // Get image dimensions
-    int imgWidth = juce::jmax (
+    // Get image dimensions (in logical pixels)
+    int imgWidth = juce::roundToInt (juce::jmax (
         toggle.getNormalImage().getWidth(),
         juce::jmax (
             toggle.getOverImage().getWidth(),
-            toggle.getDownImage().getWidth()));
-    int imgHeight = juce::jmax (
+            toggle.getDownImage().getWidth())) / imageScale);
+    int imgHeight = juce::roundToInt (juce::jmax (
         toggle.getNormalImage().getHeight(),
         juce::jmax (
             toggle.getOverImage().getHeight(),
-            toggle.getDownImage().getHeight()));
+            toggle.getDownImage().getHeight())) / imageScale);
 
     // Crop away extra space
     int hpad = juce::jmax (0, newBounds.getWidth() - imgWidth) / 2;
@@ -141,8 +167,10 @@ void ToggleWrapper::setImages (bool resizeButtonNowToFitThisImage,
                                const juce::Image& downImage,
                                float imageOpacityWhenDown,
                                juce::Colour overlayColourWhenDown,
-                               float hitTestAlphaThreshold)
+                               float hitTestAlphaThreshold,
+                               float newImageScale)
 {
+    imageScale = newImageScale;
     toggle.setImages (resizeButtonNowToFitThisImage,
                       rescaleImagesWhenButtonSizeChanges,
                       preserveImageProportions,
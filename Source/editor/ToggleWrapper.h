@@ -29,6 +29,19 @@
 
 #include <JuceHeader.h>
 
+/** Produces the outline of the through-zero toggle, as a filled path */
+juce::Path throughZeroPath (
+    float width = 32.0f,
+    float height = 32.0f,
+    float thickness = 3.0f,
+    int nCircles = 3);
+
+/** Produces a small circle, as a filled path */
+juce::Path smallCirclePath (
+    float width = 32.0f,
+    float height = 32.0f,
+    float radius = 3.0f);
+
 /** Produces an image for the through-zero toggle */
 juce::Image throughZeroImage (
     juce::Colour colour = juce::Colours::black,
@@ -67,7 +80,10 @@ public:
     /** Set the bounding boxes of the slider and label. */
     void setBounds (juce::Rectangle<int>);
 
-    /** Sets up the images to draw in various states. */
+    /** Sets up the images to draw in various states.
+        The images have imageScale pixels per logical pixel: the toggle is
+        laid out at their logical size (see setBounds).
+    */
     void setImages (bool resizeButtonNowToFitThisImage,
                     bool rescaleImagesWhenButtonSizeChanges,
                     bool preserveImageProportions,
@@ -80,7 +96,8 @@ public:
                     const juce::Image& downImage,
                     float imageOpacityWhenDown,
                     juce::Colour overlayColourWhenDown,
-                    float hitTestAlphaThreshold = 0.0f);
+                    float hitTestAlphaThreshold = 0.0f,
+                    float imageScale = 1.0f);
 
     /** Sets the callback function. */
     void setOnClick (std::function<void()>);
@@ -101,6 +118,7 @@ private:
     //==============================================================================
     bool turnNext = true;
     int labelHeight = 16;
+    float imageScale = 1.0f;
     juce::String id;
     juce::Label label;
     juce::ImageButton toggle;
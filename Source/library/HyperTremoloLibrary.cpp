@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+    HyperTremoloLibrary.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "HyperTremoloLibrary.h"
+#include "../dsp/HyperTremoloEngine.h"
+
+//==============================================================================
+struct HyperTremolo
+{
+    HyperTremoloEngine engine;
+
+    /** Planar copy of the interleaved buffers */
+    juce::AudioBuffer<float> scratch;
+    int numChannels = 0;
+};
+
+static_assert ((int) HYPERTREMOLO_NUM_PARAMETERS == (int) HyperTremoloEngine::numParameters,
+               "The C parameters must match the parameter table");
+static_assert ((int) HYPERTREMOLO_XOVER_MIX == (int) HyperTremoloEngine::xoverMixParameter,
+               "The C parameters must match the parameter table");
+static_assert ((int) HYPERTREMOLO_SC_THRESHOLD == (int) HyperTremoloEngine::scThresholdParameter,
+               "The C parameters must match the parameter table");
+static_assert ((int) HYPERTREMOLO_TREM_OVERSAMPLING == (int) HyperTremoloEngine::tremOversamplingParameter,
+               "The C parameters must match the parameter table");
+
+static bool isValidParameter (HyperTremoloParameter parameter)
+{
+    return juce::isPositiveAndBelow ((int) parameter, (int) HYPERTREMOLO_NUM_PARAMETERS);
+}
+
+//==============================================================================
+HyperTremolo* hypertremolo_create (void)
+{
+    try
+    {
+        return new HyperTremolo();
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void hypertremolo_destroy (HyperTremolo* h)
+{
+    delete h;
+}
+
+int hypertremolo_prepare (HyperTremolo* h, double sampleRate, int maximumBlockSize, int numChannels)
+{
+    if (h == nullptr || sampleRate <= 0.0 || maximumBlockSize <= 0 || numChannels <= 0)
+        return -1;
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maximumBlockSize = (juce::uint32) maximumBlockSize;
+    spec.numChannels = (juce::uint32) numChannels;
+
+    try
+    {
+        h->engine.prepare (spec);
+        h->scratch.setSize (numChannels, maximumBlockSize);
+    }
+    catch (...)
+    {
+        return -1;
+    }
+    h->numChannels = numChannels;
+    return 0;
+}
+
+void hypertremolo_reset (HyperTremolo* h)
+{
+    if (h != nullptr)
+        h->engine.reset();
+}
+
+int hypertremolo_get_latency (const HyperTremolo* h)
+{
+    return h != nullptr ? h->engine.getLatencyInSamples() : 0;
+}
+
+//==============================================================================
+int hypertremolo_set_parameter (HyperTremolo* h, HyperTremoloParameter parameter, float value)
+{
+    if (h == nullptr || ! isValidParameter (parameter))
+        return -1;
+
+    const auto index = static_cast<HyperTremoloEngine::ParameterIndex> (parameter);
+    h->engine.setParameterValue (index, HyperTremoloEngine::parameterTable[index].constrain (value));
+    return 0;
+}
+
+float hypertremolo_get_parameter (const HyperTremolo* h, HyperTremoloParameter parameter)
+{
+    if (h == nullptr || ! isValidParameter (parameter))
+        return 0.0f;
+
+    return h->engine.getParameterValue (static_cast<HyperTremoloEngine::ParameterIndex> (parameter));
+}
+
+const char* hypertremolo_get_parameter_id (HyperTremoloParameter parameter)
+{
+    return isValidParameter (parameter) ? HyperTremoloEngine::parameterTable[parameter].id : nullptr;
+}
+
+//==============================================================================
+void hypertremolo_set_control_rate (HyperTremolo* h, int enabled)
+{
+    if (h != nullptr)
+        h->engine.setControlRate (enabled != 0);
+}
+
+void hypertremolo_set_fast_math (HyperTremolo* h, int enabled)
+{
+    if (h != nullptr)
+        h->engine.setFastMath (enabled != 0);
+}
+
+//==============================================================================
+void hypertremolo_process_planar (HyperTremolo* h, float* const* channels, int numChannels, int numSamples)
+{
+    if (h == nullptr || channels == nullptr || numSamples <= 0)
+        return;
+
+    jassert (numChannels <= h->numChannels);
+    const auto channelsToProcess = (size_t) juce::jmin (numChannels, h->numChannels);
+    const auto blockSize = h->scratch.getNumSamples();
+
+    // In blocks of the prepared size, as the interleaved buffers
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        const auto n = juce::jmin (blockSize, numSamples - start);
+        juce::dsp::AudioBlock<float> block (channels, channelsToProcess, (size_t) start, (size_t) n);
+        h->engine.process (juce::dsp::ProcessContextReplacing<float> (block));
+    }
+}
+
+void hypertremolo_process_interleaved (HyperTremolo* h, float* samples, int numChannels, int numSamples)
+{
+    if (h == nullptr || samples == nullptr || numSamples <= 0)
+        return;
+
+    jassert (numChannels <= h->numChannels);
+    const auto channelsToProcess = juce::jmin (numChannels, h->numChannels);
+    const auto blockSize = h->scratch.getNumSamples();
+
+    // Deinterleave, process and interleave back, in blocks of the prepared size
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        const auto n = juce::jmin (blockSize, numSamples - start);
+        auto* frames = samples + (size_t) start * (size_t) numChannels;
+
+        for (int c = 0; c < channelsToProcess; ++c)
+        {
+            auto* dest = h->scratch.getWritePointer (c);
+            for (int i = 0; i < n; ++i)
+                dest[i] = frames[i * numChannels + c];
+        }
+
+        auto block = juce::dsp::AudioBlock<float> (h->scratch)
+                         .getSubsetChannelBlock (0, (size_t) channelsToProcess)
+                         .getSubBlock (0, (size_t) n);
+        h->engine.process (juce::dsp::ProcessContextReplacing<float> (block));
+
+        for (int c = 0; c < channelsToProcess; ++c)
+        {
+            const auto* src = h->scratch.getReadPointer (c);
+            for (int i = 0; i < n; ++i)
+                frames[i * numChannels + c] = src[i];
+        }
+    }
+}
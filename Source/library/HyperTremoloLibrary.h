@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    HyperTremoloLibrary.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef HYPERTREMOLO_LIBRARY_H
+#define HYPERTREMOLO_LIBRARY_H
+
+/*
+    C interface of the HyperTremolo DSP library.
+
+    An instance is created, prepared for a sample rate, a maximum block size
+    and a number of channels, and then processes float buffers in place.
+    Nothing is allocated after hypertremolo_prepare. Parameters can be set
+    from any thread while another one processes; otherwise, an instance
+    must not be used by two threads at the same time.
+
+    The parameters have the same IDs, ranges, steps and defaults as the
+    parameters of the plugin: values are in the plugin units (e.g. dB, Hz,
+    degrees), choices are indices and toggles are 0 or 1.
+*/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** An instance of the effect */
+typedef struct HyperTremolo HyperTremolo;
+
+/** The parameters, in the order of the plugin parameters */
+typedef enum HyperTremoloParameter
+{
+    HYPERTREMOLO_GAIN,          /**< Output gain, in dB (-20 to 20) */
+    HYPERTREMOLO_MIX,           /**< Dry/wet mix (0 to 1) */
+    HYPERTREMOLO_TREM_RATE,     /**< Tremolo rate, in Hz (0 to 20) */
+    HYPERTREMOLO_TREM_RATIO,    /**< Ratio of the tremolo rates (0.1 to 10) */
+    HYPERTREMOLO_TREM_MIX,      /**< Tremolo depth (0 to 1) */
+    HYPERTREMOLO_TREM_SHAPE,    /**< Tremolo shape: 0 sine, 1 sawtooth, 2 wavetable */
+    HYPERTREMOLO_TREM_MORPH,    /**< Wavetable morph (0 to 1) */
+    HYPERTREMOLO_TREM_SPREAD,   /**< Phase spread over the channels, in degrees (0 to 180) */
+    HYPERTREMOLO_TREM_LINK,     /**< Spread mode: 0 all channels, 1 pairs */
+    HYPERTREMOLO_TREM_ZERO,     /**< Through-zero AM (0 or 1) */
+    HYPERTREMOLO_TREM_SYNC,     /**< Sync of the tremolo phases (0 or 1) */
+    HYPERTREMOLO_XOVER_FREQ,    /**< Crossover frequency, in Hz (50 to 20000) */
+    HYPERTREMOLO_XOVER_RESON,   /**< Crossover resonance (0.125 to 4) */
+    HYPERTREMOLO_XOVER_BALANCE, /**< Crossover balance (0 to 1) */
+    HYPERTREMOLO_XOVER_MIX,     /**< Harmonic amount (0 to 1) */
+    HYPERTREMOLO_CLOCK_MODE,    /**< LFO clock shared by the instances of the process: 0 off, 1 master, 2 follow */
+    HYPERTREMOLO_CLOCK_RATIO,   /**< Ratio to the clock: 0 to 8 for 1/4, 1/3, 1/2, 2/3, 1, 3/2, 2, 3, 4 */
+    HYPERTREMOLO_CLOCK_OFFSET,  /**< Phase offset from the clock, in degrees (0 to 360) */
+    HYPERTREMOLO_ENV_MODE,      /**< Envelope follower driving the depth: 0 off, 1 peak, 2 RMS */
+    HYPERTREMOLO_ENV_AMOUNT,    /**< Depth modulation by the envelope (-1 to 1) */
+    HYPERTREMOLO_ENV_THRESHOLD, /**< Full-scale level of the envelope, in dB (-60 to 0) */
+    HYPERTREMOLO_ENV_ATTACK,    /**< Envelope attack, in ms (0.1 to 100) */
+    HYPERTREMOLO_ENV_RELEASE,   /**< Envelope release, in ms (10 to 2000) */
+    HYPERTREMOLO_ENV_SOURCE,    /**< Envelope source: 0 input, 1 sidechain (plugin only: the library has no sidechain) */
+    HYPERTREMOLO_SC_RETRIGGER,  /**< Restart of the tremolos on the sidechain onsets (0 or 1, plugin only) */
+    HYPERTREMOLO_SC_THRESHOLD,  /**< Level of the sidechain onsets, in dB (-60 to 0) */
+    HYPERTREMOLO_TREM_OVERSAMPLING, /**< Oversampling of the tremolo AM: 0 off, 1 2x, 2 4x */
+    HYPERTREMOLO_NUM_PARAMETERS
+} HyperTremoloParameter;
+
+/** Creates an instance, with all parameters at their default value.
+    Returns NULL on failure.
+*/
+HyperTremolo* hypertremolo_create (void);
+
+/** Destroys an instance */
+void hypertremolo_destroy (HyperTremolo*);
+
+/** Prepares an instance for processing. Returns 0 on success */
+int hypertremolo_prepare (HyperTremolo*, double sampleRate, int maximumBlockSize, int numChannels);
+
+/** Resets the state of an instance (e.g. before a new stream) */
+void hypertremolo_reset (HyperTremolo*);
+
+/** Gets the latency of the effect, in samples (valid after prepare).
+    It changes with HYPERTREMOLO_TREM_OVERSAMPLING, on the next call to process.
+*/
+int hypertremolo_get_latency (const HyperTremolo*);
+
+/** Sets a parameter. The value is limited to the range of the parameter
+    and snapped to its step, and applied at the start of the next call to
+    process. It can be called from any thread. Returns 0 on success
+*/
+int hypertremolo_set_parameter (HyperTremolo*, HyperTremoloParameter, float value);
+
+/** Gets the current value of a parameter */
+float hypertremolo_get_parameter (const HyperTremolo*, HyperTremoloParameter);
+
+/** Gets the ID of a parameter, as in the plugin state (e.g. "tremRate") */
+const char* hypertremolo_get_parameter_id (HyperTremoloParameter);
+
+/** Enables (1) or disables (0) the control-rate evaluation of the sine
+    LFOs, which is cheaper and within 1e-4 of the exact shape. It is applied
+    at the start of the next call to process. It is on by default.
+*/
+void hypertremolo_set_control_rate (HyperTremolo*, int enabled);
+
+/** Enables (1) or disables (0) the fast approximation of the sine LFO
+    shape (error below -89 dB), e.g. to compare the cost of the two. It is
+    applied at the start of the next call to process. It is off by default.
+*/
+void hypertremolo_set_fast_math (HyperTremolo*, int enabled);
+
+/** Processes planar buffers in place: one pointer per channel.
+    Any number of samples can be passed: buffers longer than the prepared
+    maximum block size are processed in blocks of that size. Channels beyond
+    the prepared number are left untouched.
+*/
+void hypertremolo_process_planar (HyperTremolo*, float* const* channels, int numChannels, int numSamples);
+
+/** Processes an interleaved buffer in place, with the same limits as
+    hypertremolo_process_planar
+*/
+void hypertremolo_process_interleaved (HyperTremolo*, float* samples, int numChannels, int numSamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HYPERTREMOLO_LIBRARY_H
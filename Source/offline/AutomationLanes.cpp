@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    AutomationLanes.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "AutomationLanes.h"
+
+//==============================================================================
+bool AutomationLanes::loadFromFile (const juce::File& file)
+{
+    if (! file.existsAsFile())
+    {
+        lastError = "Cannot open the automation file: " + file.getFullPathName();
+        return false;
+    }
+    return parse (file.loadFileAsString());
+}
+
+bool AutomationLanes::parse (const juce::String& text)
+{
+    for (auto& lane : lanes)
+        lane.clear();
+    lastError.clear();
+
+    juce::StringArray lines;
+    lines.addLines (text);
+
+    for (int lineNumber = 0; lineNumber < lines.size(); ++lineNumber)
+    {
+        const auto line = lines[lineNumber].trim();
+        if (line.isEmpty() || line.startsWithChar ('#'))
+            continue;
+
+        const auto tokens = juce::StringArray::fromTokens (line, false);
+        const auto error = [&lineNumber] (const juce::String& message) {
+            return "Line " + juce::String (lineNumber + 1) + ": " + message;
+        };
+
+        auto index = -1;
+        for (int i = 0; i < HyperTremoloEngine::numParameters; ++i)
+            if (tokens[0] == HyperTremoloEngine::parameterTable[i].id)
+                index = i;
+        if (index < 0)
+        {
+            lastError = error ("unknown parameter " + tokens[0]);
+            return false;
+        }
+
+        // The sync is a trigger that depends on the phases, not a curve
+        if (index == HyperTremoloEngine::tremSyncParameter)
+        {
+            lastError = error ("the sync cannot be automated");
+            return false;
+        }
+
+        // The clock is shared with the other engines of the process
+        if (index == HyperTremoloEngine::clockModeParameter)
+        {
+            lastError = error ("the clock mode cannot be automated");
+            return false;
+        }
+
+        // The latency of the render is fixed when it starts
+        if (index == HyperTremoloEngine::tremOversamplingParameter)
+        {
+            lastError = error ("the oversampling cannot be automated");
+            return false;
+        }
+
+        const auto& spec = HyperTremoloEngine::parameterTable[index];
+        auto& lane = lanes[(size_t) index];
+        for (int i = 1; i < tokens.size(); ++i)
+        {
+            const auto& token = tokens[i];
+            const auto time = token.upToFirstOccurrenceOf (":", false, false);
+            const auto value = token.fromFirstOccurrenceOf (":", false, false);
+            if (! token.containsChar (':') || time.isEmpty() || ! time.containsOnly ("0123456789.") || value.isEmpty())
+            {
+                lastError = error ("invalid breakpoint " + token);
+                return false;
+            }
+            lane.push_back ({ time.getDoubleValue(), spec.constrain (value.getFloatValue()) });
+        }
+    }
+
+    // Breakpoints at the same time keep their order, for jumps
+    for (auto& lane : lanes)
+        std::stable_sort (lane.begin(), lane.end(), [] (const Breakpoint& a, const Breakpoint& b) { return a.time < b.time; });
+    return true;
+}
+
+const juce::String& AutomationLanes::getLastError() const noexcept
+{
+    return lastError;
+}
+
+//==============================================================================
+bool AutomationLanes::isAutomated (HyperTremoloEngine::ParameterIndex index) const noexcept
+{
+    return ! lanes[(size_t) index].empty();
+}
+
+const std::vector<AutomationLanes::Breakpoint>& AutomationLanes::getLane (HyperTremoloEngine::ParameterIndex index) const noexcept
+{
+    return lanes[(size_t) index];
+}
+
+float AutomationLanes::getValueAt (HyperTremoloEngine::ParameterIndex index, double time) const noexcept
+{
+    const auto& lane = lanes[(size_t) index];
+    jassert (! lane.empty());
+
+    const auto after = std::upper_bound (lane.begin(), lane.end(), time, [] (double t, const Breakpoint& b) { return t < b.time; });
+    if (after == lane.begin())
+        return lane.front().value;
+    if (after == lane.end())
+        return lane.back().value;
+
+    const auto& a = *(after - 1);
+    if (isStepped (index))
+        return a.value;
+    const auto& b = *after;
+    return a.value + (float) ((time - a.time) / (b.time - a.time)) * (b.value - a.value);
+}
+
+bool AutomationLanes::isStepped (HyperTremoloEngine::ParameterIndex index) noexcept
+{
+    const auto kind = HyperTremoloEngine::parameterTable[index].kind;
+    return kind == ParameterSpec<HyperTremoloEngine>::choice || kind == ParameterSpec<HyperTremoloEngine>::toggle;
+}
+
+//==============================================================================
+AutomationSchedule::AutomationSchedule (const AutomationLanes& automation, double sampleRate)
+{
+    for (int i = 0; i < HyperTremoloEngine::numParameters; ++i)
+    {
+        const auto index = (HyperTremoloEngine::ParameterIndex) i;
+        if (! automation.isAutomated (index))
+            continue;
+
+        Lane lane;
+        lane.parameter = index;
+        lane.stepped = AutomationLanes::isStepped (index);
+        for (const auto& breakpoint : automation.getLane (index))
+        {
+            lane.positions.push_back ((juce::int64) std::llround (breakpoint.time * sampleRate));
+            lane.values.push_back (breakpoint.value);
+        }
+        lanes.push_back (std::move (lane));
+    }
+}
+
+float AutomationSchedule::Lane::evaluate (juce::int64 position) noexcept
+{
+    while (next < positions.size() && positions[next] <= position)
+        ++next;
+
+    if (next == 0)
+        return values.front();
+    if (next == positions.size() || stepped)
+        return values[next - 1];
+
+    const auto a = positions[next - 1], b = positions[next];
+    return values[next - 1] + (float) (position - a) / (float) (b - a) * (values[next] - values[next - 1]);
+}
+
+juce::int64 AutomationSchedule::Lane::getNextPosition (juce::int64 limit) const noexcept
+{
+    return next < positions.size() ? juce::jmin (positions[next], limit) : limit;
+}
+
+void AutomationSchedule::fillBlock (juce::int64 start, int numSamples, std::vector<AutomationPoint>& table)
+{
+    table.clear();
+    const auto end = start + numSamples;
+
+    for (auto position = start; position < end;)
+    {
+        // Changes at this sample, for the lanes whose value moved
+        auto nextPosition = end;
+        for (auto& lane : lanes)
+        {
+            const auto value = HyperTremoloEngine::parameterTable[lane.parameter].constrain (lane.evaluate (position));
+            if (! lane.hasValue || value != lane.lastValue)
+            {
+                table.push_back ({ (int) (position - start), lane.parameter, value });
+                lane.lastValue = value;
+                lane.hasValue = true;
+            }
+
+            // Ramps need the next step, holds only the next breakpoint
+            const auto ramping = ! lane.stepped && lane.next > 0 && lane.next < lane.positions.size();
+            nextPosition = lane.getNextPosition (ramping ? juce::jmin (nextPosition, position + rampInterval) : nextPosition);
+        }
+        position = nextPosition;
+    }
+}
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    AutomationLanes.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../dsp/HyperTremoloEngine.h"
+#include <JuceHeader.h>
+
+/**
+    Automation curves of the parameters, as breakpoints.
+
+    An automation file has one line per parameter: the parameter ID
+    followed by breakpoints in the form <time>:<value>, with the time in
+    seconds and the value in the units of the parameter, e.g.
+
+        # HyperTremolo automation
+        tremRate  0:2.5  4:2.5  8:6
+        xoverFreq 0:400  16:4000
+
+    Lines starting with '#' are comments. All parameters but the sync
+    trigger, the clock mode and the oversampling can be automated.
+    Continuous parameters ramp linearly between breakpoints, choices and
+    toggles step at them. Before the first breakpoint and after the last
+    one, the value is held. Two breakpoints at the same time make a jump.
+
+    The curves are the values given to the engine (see AutomationSchedule),
+    which smooths them as it smooths host automation: a jump of a smoothed
+    parameter, e.g. the gain or the mix, becomes a 50 ms ramp.
+
+    @tags{Offline}
+*/
+class AutomationLanes
+{
+public:
+    //==============================================================================
+    /** A point of an automation curve */
+    struct Breakpoint
+    {
+        double time;
+        float value;
+    };
+
+    //==============================================================================
+    AutomationLanes() = default;
+
+    /** Reads an automation file. Returns false on failure (see getLastError) */
+    bool loadFromFile (const juce::File&);
+
+    /** Reads automation from text. Returns false on failure (see getLastError) */
+    bool parse (const juce::String&);
+
+    /** Gets the description of the last failure */
+    const juce::String& getLastError() const noexcept;
+
+    //==============================================================================
+    /** Checks whether a parameter is automated */
+    bool isAutomated (HyperTremoloEngine::ParameterIndex) const noexcept;
+
+    /** Gets the breakpoints of a parameter, sorted by time */
+    const std::vector<Breakpoint>& getLane (HyperTremoloEngine::ParameterIndex) const noexcept;
+
+    /** Gets the value of an automated parameter at a time (in seconds) */
+    float getValueAt (HyperTremoloEngine::ParameterIndex, double time) const noexcept;
+
+    /** Checks whether a parameter steps between breakpoints instead of ramping */
+    static bool isStepped (HyperTremoloEngine::ParameterIndex) noexcept;
+
+private:
+    //==============================================================================
+    std::array<std::vector<Breakpoint>, HyperTremoloEngine::numParameters> lanes;
+    juce::String lastError;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomationLanes)
+};
+
+//==============================================================================
+/** A parameter change at a sample of a block */
+struct AutomationPoint
+{
+    int offset;
+    HyperTremoloEngine::ParameterIndex parameter;
+    float value;
+};
+
+/**
+    Evaluates automation lanes, block by block, into tables of parameter
+    changes for the DSP.
+
+    Blocks must be requested in order. A table has a change at each
+    breakpoint and, while a parameter ramps, every rampInterval samples,
+    sorted by offset: the DSP only has to split the block at the offsets
+    and set the values, without searching or evaluating the curves.
+    Ramps are thus followed in steps, which the smoothing of the engine
+    joins, rather than sample by sample.
+
+    @tags{Offline}
+*/
+class AutomationSchedule
+{
+public:
+    //==============================================================================
+    /** Spacing (in samples) of the changes of a ramping parameter */
+    static const int rampInterval = 32;
+
+    //==============================================================================
+    AutomationSchedule (const AutomationLanes&, double sampleRate);
+
+    /** Writes the parameter changes of the block that starts at the given
+        sample into a table (which is cleared first)
+    */
+    void fillBlock (juce::int64 start, int numSamples, std::vector<AutomationPoint>& table);
+
+private:
+    //==============================================================================
+    /** A lane with the breakpoints in samples, and a cursor */
+    struct Lane
+    {
+        HyperTremoloEngine::ParameterIndex parameter;
+        bool stepped;
+        std::vector<juce::int64> positions;
+        std::vector<float> values;
+
+        /** Number of breakpoints at or before the last evaluated sample */
+        size_t next = 0;
+        float lastValue = 0.0f;
+        bool hasValue = false;
+
+        /** Evaluates the curve at a sample (not before the last one) */
+        float evaluate (juce::int64 position) noexcept;
+
+        /** Gets the sample of the next breakpoint, or the given limit */
+        juce::int64 getNextPosition (juce::int64 limit) const noexcept;
+    };
+
+    std::vector<Lane> lanes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AutomationSchedule)
+};
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+
+//==============================================================================
+BatchRenderJob::BatchRenderJob()
+{
+    for (size_t i = 0; i < parameterValues.size(); ++i)
+        parameterValues[i] = HyperTremoloEngine::parameterTable[i].defaultValue;
+}
+
+double BatchRenderResult::getRealtimeFactor() const noexcept
+{
+    return renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0;
+}
+
+//==============================================================================
+class BatchRenderer::Worker  : public juce::Thread
+{
+public:
+    explicit Worker (BatchRenderer& o)
+        : juce::Thread ("HyperTremolo batch worker"), owner (o), processor (engine)
+    {
+    }
+
+    ~Worker() override
+    {
+        stopThread (-1);
+    }
+
+    void cancel() noexcept
+    {
+        processor.cancel();
+    }
+
+private:
+    void run() override
+    {
+        for (auto i = owner.getNextJob(); i >= 0; i = owner.getNextJob())
+            (*owner.results)[(size_t) i] = renderJob ((*owner.jobs)[(size_t) i]);
+    }
+
+    BatchRenderResult renderJob (const BatchRenderJob& job)
+    {
+        BatchRenderResult result;
+        if (owner.cancelled.load())
+        {
+            result.error = "Cancelled";
+            return result;
+        }
+
+        // The values are applied by the processor, when it prepares the engine.
+        // The phases of an offline render start synchronized: the sync trigger,
+        // which depends on the phases of the previous job, is not applied,
+        // and the workers do not share the LFO clock
+        for (size_t i = 0; i < job.parameterValues.size(); ++i)
+            engine.storeParameterValue ((HyperTremoloEngine::ParameterIndex) i, job.parameterValues[i]);
+        engine.storeParameterValue (HyperTremoloEngine::tremSyncParameter, 0.0f);
+        engine.storeParameterValue (HyperTremoloEngine::clockModeParameter, 0.0f);
+        engine.setControlRate (job.controlRate);
+        engine.setFastMath (job.fastMath);
+
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        const auto automated = job.automation != juce::File();
+        if (automated && ! automation.loadFromFile (job.automation))
+        {
+            result.error = automation.getLastError();
+            return result;
+        }
+        processor.setAutomation (automated ? &automation : nullptr);
+        processor.setSegment (job.segmentStart, job.segmentEnd, job.preRoll);
+
+        result.succeeded = processor.process (job.input, job.output);
+        result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+        if (result.succeeded)
+            result.audioSeconds = (double) processor.getInputLength() / processor.getInputSampleRate();
+        else
+            result.error = processor.getLastError();
+        return result;
+    }
+
+    BatchRenderer& owner;
+    HyperTremoloEngine engine;
+    StreamingFileProcessor processor;
+    AutomationLanes automation;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Worker)
+};
+
+//==============================================================================
+BatchRenderer::BatchRenderer (int numWorkers)
+{
+    for (int i = 0; i < juce::jmax (1, numWorkers); ++i)
+        workers.add (new Worker (*this));
+}
+
+BatchRenderer::~BatchRenderer() = default;
+
+int BatchRenderer::getNumWorkers() const noexcept
+{
+    return workers.size();
+}
+
+double BatchRenderer::getLastRenderSeconds() const noexcept
+{
+    return lastRenderSeconds;
+}
+
+int BatchRenderer::getNextJob() noexcept
+{
+    const auto i = nextJob.fetch_add (1);
+    return i < (int) jobOrder.size() ? jobOrder[(size_t) i] : -1;
+}
+
+void BatchRenderer::cancel()
+{
+    cancelled.store (true);
+    for (auto* worker : workers)
+        worker->cancel();
+}
+
+//==============================================================================
+std::vector<BatchRenderResult> BatchRenderer::render (const std::vector<BatchRenderJob>& jobsToRender)
+{
+    std::vector<BatchRenderResult> renderResults (jobsToRender.size());
+    jobs = &jobsToRender;
+    results = &renderResults;
+    nextJob.store (0);
+    cancelled.store (false);
+
+    // Jobs that would overwrite the output or the input of another job
+    // are not rendered
+    jobOrder.clear();
+    for (size_t i = 0; i < jobsToRender.size(); ++i)
+    {
+        const auto& output = jobsToRender[i].output;
+        for (size_t j = 0; j < jobsToRender.size() && renderResults[i].error.isEmpty(); ++j)
+        {
+            if (j != i && output == jobsToRender[j].output)
+                renderResults[i].error = "The output is also the output of another job: " + output.getFullPathName();
+            else if (j != i && output == jobsToRender[j].input)
+                renderResults[i].error = "The output is the input of another job: " + output.getFullPathName();
+        }
+
+        if (renderResults[i].error.isEmpty())
+            jobOrder.push_back ((int) i);
+    }
+
+    // Longest jobs first, so that the workers finish at about the same time
+    std::vector<juce::int64> sizes;
+    for (const auto& job : jobsToRender)
+        sizes.push_back (job.input.getSize());
+    std::stable_sort (jobOrder.begin(), jobOrder.end(), [&sizes] (int a, int b) { return sizes[(size_t) a] > sizes[(size_t) b]; });
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    const auto numActive = juce::jmin (workers.size(), (int) jobOrder.size());
+    for (int i = 0; i < numActive; ++i)
+        workers[i]->startThread();
+    for (int i = 0; i < numActive; ++i)
+        workers[i]->waitForThreadToExit (-1);
+    lastRenderSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+    jobs = nullptr;
+    results = nullptr;
+    return renderResults;
+}
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "StreamingFileProcessor.h"
+#include <JuceHeader.h>
+
+/** A file to render, with the parameter values to render it with */
+struct BatchRenderJob
+{
+    /** Constructor. All parameters are set to their default value */
+    BatchRenderJob();
+
+    juce::File input, output;
+    std::array<float, HyperTremoloEngine::numParameters> parameterValues;
+
+    /** Automation file (see AutomationLanes), or none */
+    juce::File automation;
+
+    /** Segment of the output to render, with its pre-roll
+        (see StreamingFileProcessor::setSegment). By default, the whole file
+    */
+    juce::int64 segmentStart = 0, segmentEnd = -1, preRoll = 0;
+
+    /** Evaluation options of the LFOs
+        (see HyperTremoloEngine::setControlRate and setFastMath)
+    */
+    bool controlRate = HYPERTREMOLO_CONTROL_RATE != 0, fastMath = HYPERTREMOLO_FAST_MATH != 0;
+};
+
+/** Outcome and throughput of a rendered job */
+struct BatchRenderResult
+{
+    bool succeeded = false;
+    juce::String error;
+
+    /** Length of the input, in seconds of audio */
+    double audioSeconds = 0.0;
+
+    /** Time spent rendering, in seconds */
+    double renderSeconds = 0.0;
+
+    /** Seconds of audio rendered per second */
+    double getRealtimeFactor() const noexcept;
+};
+
+/**
+    Renders a list of jobs in parallel, one job per worker thread.
+
+    Each worker owns an engine and a StreamingFileProcessor, which are kept
+    between jobs (and between calls to render): preparing an engine for
+    the same spec only resets it. Idle workers take the next job from a
+    shared queue, ordered by decreasing input size, so that the longest
+    jobs do not end up last.
+
+    Each job starts from a reset engine with its own parameter values, so
+    the output does not depend on the number of workers or on the order of
+    the jobs: it is identical to the one of a serial render.
+
+    @tags{Offline}
+*/
+class BatchRenderer
+{
+public:
+    //==============================================================================
+    /** Constructor. The default number of workers is the number of CPU cores */
+    explicit BatchRenderer (int numWorkers = juce::SystemStats::getNumCpus());
+    ~BatchRenderer();
+
+    //==============================================================================
+    /** Renders the jobs and waits for them to finish.
+        Returns the results in the order of the jobs.
+
+        A job fails without rendering if its output is the output or the
+        input of another job. A job whose output is its own input fails
+        as well (see StreamingFileProcessor::process).
+    */
+    std::vector<BatchRenderResult> render (const std::vector<BatchRenderJob>&);
+
+    /** Stops the current call to render (from any thread).
+        The jobs that are not finished fail.
+    */
+    void cancel();
+
+    /** Gets the wall-clock time (in seconds) of the last call to render */
+    double getLastRenderSeconds() const noexcept;
+
+    /** Gets the number of worker threads */
+    int getNumWorkers() const noexcept;
+
+private:
+    //==============================================================================
+    class Worker;
+
+    /** Gets the next job to render, or -1 if there are none left */
+    int getNextJob() noexcept;
+
+    //==============================================================================
+    juce::OwnedArray<Worker> workers;
+
+    const std::vector<BatchRenderJob>* jobs = nullptr;
+    std::vector<BatchRenderResult>* results = nullptr;
+    std::vector<int> jobOrder;
+    std::atomic<int> nextJob { 0 };
+    std::atomic<bool> cancelled { false };
+    double lastRenderSeconds = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BatchRenderer)
+};
@@ -0,0 +1,314 @@
+/*
+  ==============================================================================
+
+    RenderMain.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "SegmentedRenderer.h"
+#include <iostream>
+
+/** Prints the usage of the renderer, with the list of parameters */
+static void printUsage()
+{
+    std::cout << "Usage: HyperTremoloRender [--threads <n>] [--split] [--verify] [--fast-math] [--audio-rate] [automation=<file>] [<parameter>=<value> ...] <input> <output.wav>" << std::endl
+              << "       HyperTremoloRender [--threads <n>] [--verify] [--fast-math] [--audio-rate] --batch <jobs.txt>" << std::endl
+              << std::endl
+              << "Each line of a job list is: <input> <output.wav> [automation=<file>] [<parameter>=<value> ...]" << std::endl
+              << "(paths with spaces must be quoted)" << std::endl
+              << std::endl
+              << "--split renders a single file in segments on all the threads" << std::endl
+              << "--verify renders the jobs again on a single thread and compares the outputs" << std::endl
+              << "(with --split, the outputs may differ by float rounding)" << std::endl
+              << "--fast-math approximates the sine shape of the LFOs with a polynomial" << std::endl
+              << "--audio-rate evaluates the sine shape of the LFOs on every sample" << std::endl
+              << std::endl
+              << "Parameters:" << std::endl;
+
+    for (const auto& spec : HyperTremoloEngine::parameterTable)
+        std::cout << "  " << spec.id << " (" << spec.minimum << " to " << spec.maximum
+                  << ", default " << spec.defaultValue << ")" << std::endl;
+}
+
+/** Sets a parameter of a job from an argument in the form <id>=<value>,
+    or its automation file from automation=<file>.
+    Returns false if the parameter does not exist.
+*/
+static bool setParameter (BatchRenderJob& job, const juce::String& argument, const juce::File& directory)
+{
+    const auto id = argument.upToFirstOccurrenceOf ("=", false, false);
+    const auto text = argument.fromFirstOccurrenceOf ("=", false, false);
+    if (id == "automation")
+    {
+        job.automation = directory.getChildFile (text.unquoted());
+        return true;
+    }
+
+    const auto value = text.getFloatValue();
+
+    for (size_t i = 0; i < job.parameterValues.size(); ++i)
+    {
+        const auto& spec = HyperTremoloEngine::parameterTable[i];
+        if (id == spec.id)
+        {
+            job.parameterValues[i] = spec.constrain (value);
+            return true;
+        }
+    }
+    std::cerr << "Unknown parameter: " << argument << std::endl;
+    return false;
+}
+
+/** Makes a job from a list of arguments: parameters and two files.
+    Returns false if the arguments are not valid.
+*/
+static bool parseJob (BatchRenderJob& job, const juce::StringArray& arguments, const juce::File& directory)
+{
+    juce::StringArray files;
+    for (const auto& argument : arguments)
+    {
+        if (argument.contains ("="))
+        {
+            if (! setParameter (job, argument, directory))
+                return false;
+        }
+        else
+        {
+            files.add (argument.unquoted());
+        }
+    }
+
+    if (files.size() != 2)
+        return false;
+
+    job.input = directory.getChildFile (files[0]);
+    job.output = directory.getChildFile (files[1]);
+    return true;
+}
+
+/** Reads a job list. Relative paths are relative to the list */
+static bool parseJobList (std::vector<BatchRenderJob>& jobs, const juce::File& list)
+{
+    juce::StringArray lines;
+    list.readLines (lines);
+
+    for (const auto& line : lines)
+    {
+        const auto tokens = juce::StringArray::fromTokens (line.trim(), true);
+        if (tokens.isEmpty() || line.trimStart().startsWithChar ('#'))
+            continue;
+
+        BatchRenderJob job;
+        if (! parseJob (job, tokens, list.getParentDirectory()))
+        {
+            std::cerr << "Invalid job: " << line << std::endl;
+            return false;
+        }
+        jobs.push_back (job);
+    }
+    return true;
+}
+
+/** Gets the largest absolute difference between the samples of two audio files,
+    or a negative value if they cannot be read or do not have the same size
+*/
+static float getMaxDifference (const juce::File& a, const juce::File& b)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> readerA (formatManager.createReaderFor (a));
+    std::unique_ptr<juce::AudioFormatReader> readerB (formatManager.createReaderFor (b));
+    if (readerA == nullptr || readerB == nullptr
+        || readerA->numChannels != readerB->numChannels
+        || readerA->lengthInSamples != readerB->lengthInSamples)
+        return -1.0f;
+
+    const auto numChannels = (int) readerA->numChannels;
+    const auto blockSize = StreamingFileProcessor::defaultBlockSize;
+    juce::AudioBuffer<float> bufferA (numChannels, blockSize), bufferB (numChannels, blockSize);
+
+    auto maxDifference = 0.0f;
+    for (juce::int64 start = 0; start < readerA->lengthInSamples; start += blockSize)
+    {
+        const auto numSamples = (int) juce::jmin ((juce::int64) blockSize, readerA->lengthInSamples - start);
+        readerA->read (&bufferA, 0, numSamples, start, true, true);
+        readerB->read (&bufferB, 0, numSamples, start, true, true);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                maxDifference = juce::jmax (maxDifference, std::abs (bufferA.getSample (channel, i) - bufferB.getSample (channel, i)));
+    }
+    return maxDifference;
+}
+
+/** Gets the largest difference between a segmented render and a serial one:
+    float rounding (-120 dBFS), or one step of an integer output, which the
+    rounding can flip
+*/
+static float getSegmentedTolerance (const juce::File& output)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (output));
+    const auto step = reader != nullptr && ! reader->usesFloatingPointData
+                          ? std::ldexp (1.0f, 1 - (int) reader->bitsPerSample)
+                          : 0.0f;
+    return juce::jmax (juce::Decibels::decibelsToGain (-120.0f, -200.0f), step);
+}
+
+/** Renders the jobs again on a single thread, into temporary files, and
+    compares them with the outputs, which must be identical (or, for a
+    segmented render, within getSegmentedTolerance).
+    Returns the number of outputs that differ.
+*/
+static int verifyJobs (const std::vector<BatchRenderJob>& jobs, bool segmented)
+{
+    auto serialJobs = jobs;
+    for (auto& job : serialJobs)
+        job.output = juce::File::createTempFile (".wav");
+
+    BatchRenderer serialRenderer (1);
+    const auto serialResults = serialRenderer.render (serialJobs);
+
+    auto differences = 0;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const auto difference = serialResults[i].succeeded ? getMaxDifference (jobs[i].output, serialJobs[i].output) : -1.0f;
+        const auto tolerance = segmented ? getSegmentedTolerance (jobs[i].output) : 0.0f;
+        serialJobs[i].output.deleteFile();
+
+        std::cout << jobs[i].output.getFullPathName() << ": ";
+        if (difference == 0.0f)
+            std::cout << "identical to the serial render" << std::endl;
+        else if (difference > 0.0f && difference <= tolerance)
+            std::cout << "matches the serial render to within "
+                      << juce::Decibels::gainToDecibels (difference, -200.0f) << " dBFS" << std::endl;
+        else if (difference > 0.0f)
+            std::cout << "differs from the serial render by up to "
+                      << juce::Decibels::gainToDecibels (difference, -200.0f) << " dBFS" << std::endl;
+        else
+            std::cout << "cannot be compared with the serial render" << std::endl;
+
+        if (difference < 0.0f || difference > tolerance)
+            ++differences;
+    }
+    return differences;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    auto numThreads = juce::SystemStats::getNumCpus();
+    juce::File jobList;
+    juce::StringArray arguments;
+    auto split = false, verify = false, fastMath = HYPERTREMOLO_FAST_MATH != 0, audioRate = HYPERTREMOLO_CONTROL_RATE == 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String argument (juce::CharPointer_UTF8 (argv[i]));
+        if (argument == "--threads" && i + 1 < argc)
+            numThreads = juce::jmax (1, juce::String (argv[++i]).getIntValue());
+        else if (argument == "--split")
+            split = true;
+        else if (argument == "--verify")
+            verify = true;
+        else if (argument == "--fast-math")
+            fastMath = true;
+        else if (argument == "--audio-rate")
+            audioRate = true;
+        else if (argument == "--batch" && i + 1 < argc)
+            jobList = cwd.getChildFile (juce::String (juce::CharPointer_UTF8 (argv[++i])));
+        else
+            arguments.add (argument);
+    }
+
+    std::vector<BatchRenderJob> jobs;
+    if (jobList != juce::File())
+    {
+        if (! arguments.isEmpty() || ! parseJobList (jobs, jobList))
+        {
+            printUsage();
+            return 1;
+        }
+    }
+    else
+    {
+        BatchRenderJob job;
+        if (! parseJob (job, arguments, cwd))
+        {
+            printUsage();
+            return 1;
+        }
+        jobs.push_back (job);
+    }
+
+    for (auto& job : jobs)
+    {
+        job.fastMath = fastMath;
+        job.controlRate = ! audioRate;
+    }
+
+    std::vector<BatchRenderResult> results;
+    auto seconds = 0.0;
+    BatchRenderer renderer (split ? numThreads : juce::jmin (numThreads, (int) jobs.size()));
+    if (split && jobs.size() == 1)
+    {
+        SegmentedRenderer segmentedRenderer (renderer);
+        results.push_back (segmentedRenderer.render (jobs.front()));
+        seconds = results.front().renderSeconds;
+        std::cout << segmentedRenderer.getLastNumSegments() << " segments" << std::endl;
+    }
+    else
+    {
+        results = renderer.render (jobs);
+        seconds = renderer.getLastRenderSeconds();
+    }
+
+    auto failures = 0;
+    auto totalAudioSeconds = 0.0;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const auto& result = results[i];
+        std::cout << jobs[i].output.getFullPathName() << ": ";
+        if (result.succeeded)
+        {
+            std::cout << result.audioSeconds << " s in " << result.renderSeconds << " s ("
+                      << result.getRealtimeFactor() << "x realtime)" << std::endl;
+            totalAudioSeconds += result.audioSeconds;
+        }
+        else
+        {
+            std::cout << "failed: " << result.error << std::endl;
+            ++failures;
+        }
+    }
+
+    std::cout << jobs.size() - (size_t) failures << " of " << jobs.size() << " files, "
+              << totalAudioSeconds << " s in " << seconds << " s on " << renderer.getNumWorkers() << " threads ("
+              << (seconds > 0.0 ? totalAudioSeconds / seconds : 0.0) << "x realtime)" << std::endl;
+
+    if (verify && failures == 0)
+        failures = verifyJobs (jobs, split && jobs.size() == 1);
+    return failures > 0 ? 1 : 0;
+}
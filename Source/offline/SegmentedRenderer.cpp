@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    SegmentedRenderer.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "SegmentedRenderer.h"
+
+//==============================================================================
+constexpr double SegmentedRenderer::preRollSeconds;
+constexpr double SegmentedRenderer::envelopeTimeConstants;
+constexpr double SegmentedRenderer::minimumSegmentSeconds;
+constexpr double SegmentedRenderer::minimumSegmentPreRolls;
+
+SegmentedRenderer::SegmentedRenderer (BatchRenderer& r)
+    : renderer (r)
+{
+    formatManager.registerBasicFormats();
+}
+
+int SegmentedRenderer::getLastNumSegments() const noexcept
+{
+    return lastNumSegments;
+}
+
+double SegmentedRenderer::getPreRollSeconds (const BatchRenderJob& job) noexcept
+{
+    // The release is the slowest time constant of the envelope
+    const auto& values = job.parameterValues;
+    if (values[HyperTremoloEngine::envModeParameter] == 0.0f)
+        return preRollSeconds;
+    return juce::jmax (preRollSeconds, envelopeTimeConstants * 0.001 * (double) values[HyperTremoloEngine::envReleaseParameter]);
+}
+
+//==============================================================================
+BatchRenderResult SegmentedRenderer::render (const BatchRenderJob& job)
+{
+    lastNumSegments = 1;
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (job.input));
+    // A job that renders in place is left to the batch renderer, which rejects it
+    if (reader == nullptr || job.automation != juce::File() || job.output == job.input || renderer.getNumWorkers() < 2)
+        return renderer.render ({ job }).front();
+
+    // Segments of equal length, one per worker, starting on blocks
+    const auto blockSize = (juce::int64) StreamingFileProcessor::defaultBlockSize;
+    const auto sampleRate = reader->sampleRate;
+    const auto preRoll = getPreRollSeconds (job);
+    const auto minimumLength = (juce::int64) (juce::jmax (minimumSegmentSeconds, minimumSegmentPreRolls * preRoll) * sampleRate);
+    auto segmentLength = juce::jmax (minimumLength, reader->lengthInSamples / renderer.getNumWorkers() + 1);
+    segmentLength = (segmentLength + blockSize - 1) / blockSize * blockSize;
+    const auto numSegments = (int) ((reader->lengthInSamples + segmentLength - 1) / segmentLength);
+    reader.reset();
+
+    if (numSegments < 2)
+        return renderer.render ({ job }).front();
+
+    std::vector<BatchRenderJob> segments ((size_t) numSegments, job);
+    for (int i = 0; i < numSegments; ++i)
+    {
+        auto& segment = segments[(size_t) i];
+        segment.output = job.output.getSiblingFile (job.output.getFileNameWithoutExtension() + ".part" + juce::String (i) + ".wav")
+                                   .getNonexistentSibling (false);
+        segment.segmentStart = i * segmentLength;
+        segment.segmentEnd = i + 1 < numSegments ? (i + 1) * segmentLength : -1;
+        segment.preRoll = (juce::int64) std::ceil (preRoll * sampleRate);
+    }
+    lastNumSegments = numSegments;
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    const auto results = renderer.render (segments);
+
+    BatchRenderResult result;
+    for (const auto& r : results)
+    {
+        result.audioSeconds += r.audioSeconds;
+        if (! r.succeeded && result.error.isEmpty())
+            result.error = r.error;
+    }
+
+    // Each segment reports the length of the whole input
+    result.audioSeconds /= (double) numSegments;
+    result.succeeded = result.error.isEmpty() && splice (segments, job.output, result.error);
+    result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+    for (const auto& segment : segments)
+        segment.output.deleteFile();
+    return result;
+}
+
+//==============================================================================
+bool SegmentedRenderer::splice (const std::vector<BatchRenderJob>& segments, const juce::File& output, juce::String& error)
+{
+    // The segments are WAV files in the format of the output:
+    // copying their samples is lossless. They are spliced into a temporary
+    // file, which replaces the output only when all of them are written
+    juce::WavAudioFormat wav;
+    juce::TemporaryFile temporaryOutput (output);
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    for (const auto& segment : segments)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (segment.output));
+        if (reader == nullptr)
+        {
+            error = "Cannot read the segment " + segment.output.getFullPathName();
+            return false;
+        }
+
+        if (writer == nullptr)
+        {
+            std::unique_ptr<juce::OutputStream> stream (temporaryOutput.getFile().createOutputStream());
+            if (stream != nullptr)
+                writer.reset (wav.createWriterFor (stream.get(), reader->sampleRate, reader->numChannels, (int) reader->bitsPerSample, {}, 0));
+            if (writer == nullptr)
+            {
+                error = "Cannot create the output file: " + output.getFullPathName();
+                return false;
+            }
+            stream.release();
+        }
+
+        if (! writer->writeFromAudioReader (*reader, 0, reader->lengthInSamples))
+        {
+            error = "Cannot write the output file: " + output.getFullPathName();
+            return false;
+        }
+    }
+
+    writer.reset();
+    if (! temporaryOutput.overwriteTargetFileWithTemporary())
+    {
+        error = "Cannot replace the output file: " + output.getFullPathName();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    SegmentedRenderer.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "BatchRenderer.h"
+#include <JuceHeader.h>
+
+/**
+    Renders a single long file on many threads, by splitting it into
+    segments that are rendered as parallel jobs and then spliced.
+
+    A segment starts on a block of the pipeline, so the engine processes
+    the same chunks as in a serial render. Its LFOs are advanced to the
+    start in closed form (the phase accumulators are exact), and its
+    filters, mixers and envelope are warmed up on the input before it.
+    Without the envelope, the slowest state is the crossover at 50 Hz with
+    the highest resonance, which decays with a time constant of about
+    25 ms, and preRollSeconds is enough. With the envelope, the slowest
+    state is its follower, which decays with the release time (up to 2 s):
+    the pre-roll lasts envelopeTimeConstants release times. Either way,
+    what is left of the difference from the serial state is below -120 dB,
+    so the output matches a serial render to within float rounding.
+
+    Files with automation are rendered serially, as the rate curves have
+    no closed form for the phases.
+
+    @tags{Offline}
+*/
+class SegmentedRenderer
+{
+public:
+    //==============================================================================
+    /** Minimum length of the input processed before each segment, to warm up the filters */
+    static constexpr double preRollSeconds = 1.0;
+
+    /** Length of the pre-roll in release times of the envelope, when it is on:
+        a difference in the envelope decays to exp (-14), below -120 dB
+    */
+    static constexpr double envelopeTimeConstants = 14.0;
+
+    /** Minimum length of a segment, so that the pre-roll stays a small overhead */
+    static constexpr double minimumSegmentSeconds = 20.0;
+
+    /** Minimum length of a segment, in pre-rolls */
+    static constexpr double minimumSegmentPreRolls = 20.0;
+
+    //==============================================================================
+    /** Gets the length of the pre-roll of the segments of a job, in seconds */
+    static double getPreRollSeconds (const BatchRenderJob&) noexcept;
+
+    //==============================================================================
+    /** Constructor. The segments are rendered by the workers of the batch renderer */
+    explicit SegmentedRenderer (BatchRenderer&);
+
+    /** Renders a job in segments and waits for it to finish */
+    BatchRenderResult render (const BatchRenderJob&);
+
+    /** Gets the number of segments of the last render */
+    int getLastNumSegments() const noexcept;
+
+private:
+    //==============================================================================
+    /** Writes the segments into the output, one after the other */
+    bool splice (const std::vector<BatchRenderJob>& segments, const juce::File& output, juce::String& error);
+
+    //==============================================================================
+    BatchRenderer& renderer;
+    juce::AudioFormatManager formatManager;
+    int lastNumSegments = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SegmentedRenderer)
+};
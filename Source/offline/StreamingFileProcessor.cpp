@@ -0,0 +1,396 @@
+/*
+  ==============================================================================
+
+    StreamingFileProcessor.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "StreamingFileProcessor.h"
+
+//==============================================================================
+class StreamingFileProcessor::StageThread  : public juce::Thread
+{
+public:
+    StageThread (const juce::String& name, std::function<void()> f)
+        : juce::Thread (name), body (std::move (f))
+    {
+    }
+
+    ~StageThread() override
+    {
+        stopThread (-1);
+    }
+
+private:
+    void run() override
+    {
+        body();
+    }
+
+    std::function<void()> body;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StageThread)
+};
+
+//==============================================================================
+StreamingFileProcessor::StreamingFileProcessor (HyperTremoloEngine& e, int bs)
+    : engine (e), blockSize (bs)
+{
+    jassert (blockSize > 0);
+    formatManager.registerBasicFormats();
+}
+
+StreamingFileProcessor::~StreamingFileProcessor() = default;
+
+void StreamingFileProcessor::setAutomation (const AutomationLanes* a) noexcept
+{
+    automation = a;
+}
+
+void StreamingFileProcessor::setSegment (juce::int64 start, juce::int64 end, juce::int64 preRollSamples) noexcept
+{
+    jassert (start % blockSize == 0);
+    segmentStart = start;
+    segmentEnd = end;
+    preRoll = preRollSamples;
+}
+
+void StreamingFileProcessor::clearSegment() noexcept
+{
+    setSegment (0, -1, 0);
+}
+
+int StreamingFileProcessor::getBlockSize() const noexcept
+{
+    return blockSize;
+}
+
+void StreamingFileProcessor::cancel() noexcept
+{
+    failed.store (true);
+}
+
+float StreamingFileProcessor::getProgress() const noexcept
+{
+    return progress.load (std::memory_order_relaxed);
+}
+
+const juce::String& StreamingFileProcessor::getLastError() const noexcept
+{
+    return lastError;
+}
+
+void StreamingFileProcessor::fail (const juce::String& message)
+{
+    {
+        const juce::ScopedLock sl (errorLock);
+        if (lastError.isEmpty())
+            lastError = message;
+    }
+    failed.store (true);
+    readEvent.signal();
+    processedEvent.signal();
+    writtenEvent.signal();
+}
+
+bool StreamingFileProcessor::waitFor (const std::atomic<juce::int64>& counter, juce::int64 value, juce::WaitableEvent& event) const
+{
+    while (counter.load() <= value)
+    {
+        if (failed.load())
+            return false;
+        event.wait (100);
+    }
+    return ! failed.load();
+}
+
+juce::int64 StreamingFileProcessor::getInputLength() const noexcept
+{
+    return inputLength;
+}
+
+double StreamingFileProcessor::getInputSampleRate() const noexcept
+{
+    return inputSampleRate;
+}
+
+//==============================================================================
+std::unique_ptr<juce::AudioFormatReader> StreamingFileProcessor::createReader (const juce::File& input)
+{
+    mappedReader = nullptr;
+
+    if (auto* format = formatManager.findFormatForFileExtension (input.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (input));
+        if (mapped != nullptr && mapped->mapSectionOfFile ({ 0, juce::jmin (mapped->lengthInSamples, (juce::int64) blockSize) }))
+        {
+            mappedReader = mapped.get();
+            return std::move (mapped);
+        }
+    }
+
+    // Formats that can't be mapped (e.g. compressed ones) are streamed
+    return std::unique_ptr<juce::AudioFormatReader> (formatManager.createReaderFor (input));
+}
+
+std::unique_ptr<juce::AudioFormatWriter> StreamingFileProcessor::createWriter (const juce::File& output, const juce::AudioFormatReader& reader)
+{
+    juce::WavAudioFormat wav;
+    const auto bitDepths = wav.getPossibleBitDepths();
+    const auto bitsPerSample = reader.usesFloatingPointData || ! bitDepths.contains ((int) reader.bitsPerSample)
+                                   ? 32
+                                   : (int) reader.bitsPerSample;
+
+    std::unique_ptr<juce::OutputStream> stream (output.createOutputStream());
+    if (stream == nullptr)
+        return nullptr;
+
+    std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (stream.get(),
+                                                                          reader.sampleRate,
+                                                                          reader.numChannels,
+                                                                          bitsPerSample,
+                                                                          {},
+                                                                          0));
+    if (writer != nullptr)
+        stream.release();
+    return writer;
+}
+
+//==============================================================================
+void StreamingFileProcessor::readBlocks (juce::AudioFormatReader& reader, juce::int64 numBlocksToRead)
+{
+    for (juce::int64 i = 0; i < numBlocksToRead; ++i)
+    {
+        // Wait for the block to be written before reusing it
+        if (! waitFor (numWritten, i - numBlocks, writtenEvent))
+            return;
+
+        auto& block = blocks[(size_t) (i % numBlocks)];
+        block.start = renderStart + i * blockSize;
+        block.numSamples = (int) juce::jmin ((juce::int64) blockSize, totalSamples - block.start);
+
+        // Past the end of the input (latency flush) the samples are zeros
+        const auto start = juce::jmin (block.start, reader.lengthInSamples);
+        const auto numToRead = (int) juce::jlimit ((juce::int64) 0, (juce::int64) block.numSamples, reader.lengthInSamples - start);
+        block.buffer.clear();
+
+        if (schedule != nullptr)
+            schedule->fillBlock (block.start, block.numSamples, block.automation);
+        else
+            block.automation.clear();
+
+        if (numToRead > 0)
+        {
+            const juce::Range<juce::int64> range (start, start + numToRead);
+            if (mappedReader != nullptr && ! mappedReader->getMappedSection().contains (range))
+            {
+                const auto end = juce::jmin (reader.lengthInSamples, start + (juce::int64) blockSize * blocksPerMappedWindow);
+                if (! mappedReader->mapSectionOfFile ({ start, end }))
+                {
+                    fail ("Cannot map the input file");
+                    return;
+                }
+            }
+
+            if (! reader.read (&block.buffer, 0, numToRead, start, true, true))
+            {
+                fail ("Cannot read the input file");
+                return;
+            }
+        }
+
+        numRead.store (i + 1);
+        readEvent.signal();
+    }
+}
+
+void StreamingFileProcessor::writeBlocks (juce::AudioFormatWriter& writer, juce::int64 numBlocksToWrite, juce::int64 writeStart)
+{
+    for (juce::int64 i = 0; i < numBlocksToWrite; ++i)
+    {
+        if (! waitFor (numProcessed, i, processedEvent))
+            return;
+
+        // The samples before the start (the latency, or the pre-roll) are dropped
+        const auto& block = blocks[(size_t) (i % numBlocks)];
+        const auto skip = (int) juce::jlimit ((juce::int64) 0, (juce::int64) block.numSamples, writeStart - block.start);
+        if (block.numSamples > skip && ! writer.writeFromAudioSampleBuffer (block.buffer, skip, block.numSamples - skip))
+        {
+            fail ("Cannot write the output file");
+            return;
+        }
+
+        numWritten.store (i + 1);
+        writtenEvent.signal();
+    }
+}
+
+void StreamingFileProcessor::processBlock (Block& block) noexcept
+{
+    auto audioBlock = juce::dsp::AudioBlock<float> (block.buffer).getSubBlock (0, (size_t) block.numSamples);
+
+    size_t done = 0;
+    for (const auto& point : block.automation)
+    {
+        const auto offset = (size_t) point.offset;
+        if (offset > done)
+        {
+            auto subBlock = audioBlock.getSubBlock (done, offset - done);
+            engine.process (juce::dsp::ProcessContextReplacing<float> (subBlock));
+            done = offset;
+        }
+        engine.setParameterValue (point.parameter, point.value);
+    }
+
+    if (done < audioBlock.getNumSamples())
+    {
+        auto subBlock = audioBlock.getSubBlock (done);
+        engine.process (juce::dsp::ProcessContextReplacing<float> (subBlock));
+    }
+}
+
+//==============================================================================
+bool StreamingFileProcessor::process (const juce::File& input, const juce::File& output)
+{
+    lastError.clear();
+    failed.store (false);
+    progress.store (0.0f);
+    numRead.store (0);
+    numProcessed.store (0);
+    numWritten.store (0);
+    inputLength = 0;
+    inputSampleRate = 0.0;
+
+    const auto segmented = segmentStart > 0 || segmentEnd >= 0;
+    if (segmented && automation != nullptr)
+    {
+        lastError = "Segments cannot be rendered with automation";
+        return false;
+    }
+
+    // The input is read while the output is written
+    if (input == output)
+    {
+        lastError = "The output cannot be the input file: " + output.getFullPathName();
+        return false;
+    }
+
+    auto reader = createReader (input);
+    if (reader == nullptr)
+    {
+        lastError = "Cannot open the input file: " + input.getFullPathName();
+        return false;
+    }
+
+    // The output is written to a temporary file, which replaces it on success:
+    // an existing output is left untouched by a failed render
+    juce::TemporaryFile temporaryOutput (output);
+    auto writer = createWriter (temporaryOutput.getFile(), *reader);
+    if (writer == nullptr)
+    {
+        lastError = "Cannot create the output file: " + output.getFullPathName();
+        return false;
+    }
+
+    inputLength = reader->lengthInSamples;
+    inputSampleRate = reader->sampleRate;
+
+    const auto numChannels = (int) reader->numChannels;
+    for (auto& block : blocks)
+        block.buffer.setSize (numChannels, blockSize);
+
+    // Automated parameters start from their first value, without smoothing
+    schedule.reset();
+    if (automation != nullptr)
+    {
+        schedule.reset (new AutomationSchedule (*automation, reader->sampleRate));
+        for (int i = 0; i < HyperTremoloEngine::numParameters; ++i)
+        {
+            const auto index = (HyperTremoloEngine::ParameterIndex) i;
+            if (automation->isAutomated (index))
+                engine.storeParameterValue (index, automation->getValueAt (index, 0.0));
+        }
+    }
+
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = reader->sampleRate;
+    spec.maximumBlockSize = (juce::uint32) blockSize;
+    spec.numChannels = (juce::uint32) numChannels;
+    engine.prepare (spec);
+    engine.reset();
+
+    // Process as many samples as the latency after the end of the input,
+    // and write from the latency (or from the start of the segment)
+    const auto latency = (juce::int64) engine.getLatencyInSamples();
+    const auto outputEnd = reader->lengthInSamples + latency;
+    totalSamples = segmentEnd >= 0 ? juce::jmin (segmentEnd, outputEnd) : outputEnd;
+    const auto writeStart = juce::jmax (segmentStart, latency);
+
+    // The pre-roll starts on a block, so the chunks are the same as in a
+    // full render. The LFOs jump to it, the filters warm up on it
+    renderStart = juce::jmax ((juce::int64) 0, segmentStart - preRoll) / blockSize * blockSize;
+    engine.skip ((juce::uint64) renderStart);
+    const auto totalBlocks = juce::jmax ((juce::int64) 0, (totalSamples - renderStart + blockSize - 1) / blockSize);
+
+    {
+        StageThread readerThread ("HyperTremolo file reader", [this, &reader, totalBlocks] { readBlocks (*reader, totalBlocks); });
+        StageThread writerThread ("HyperTremolo file writer", [this, &writer, totalBlocks, writeStart] { writeBlocks (*writer, totalBlocks, writeStart); });
+        readerThread.startThread();
+        writerThread.startThread();
+
+        juce::ScopedNoDenormals noDenormals;
+        for (juce::int64 i = 0; i < totalBlocks; ++i)
+        {
+            if (! waitFor (numRead, i, readEvent))
+                break;
+
+            processBlock (blocks[(size_t) (i % numBlocks)]);
+
+            numProcessed.store (i + 1);
+            processedEvent.signal();
+            progress.store ((float) (i + 1) / (float) totalBlocks, std::memory_order_relaxed);
+        }
+
+        // Wait for the writer to finish (or to fail)
+        waitFor (numWritten, totalBlocks - 1, writtenEvent);
+        writtenEvent.signal();
+    }
+
+    writer.reset();
+    mappedReader = nullptr;
+    schedule.reset();
+
+    if (failed.load())
+    {
+        if (lastError.isEmpty())
+            lastError = "Cancelled";
+        return false;
+    }
+
+    if (! temporaryOutput.overwriteTargetFileWithTemporary())
+    {
+        lastError = "Cannot replace the output file: " + output.getFullPathName();
+        return false;
+    }
+    return true;
+}
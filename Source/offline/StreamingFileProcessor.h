@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    StreamingFileProcessor.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../dsp/HyperTremoloEngine.h"
+#include "AutomationLanes.h"
+#include <JuceHeader.h>
+
+/**
+    Offline processor of audio files through a HyperTremoloEngine, in
+    constant memory.
+
+    The processing is a pipeline of three stages over a fixed ring of
+    blocks: a reader thread reads the input (through a memory-mapped reader
+    when the format allows it, mapping a window of the file at a time), the
+    calling thread runs the DSP, and a writer thread writes the output WAV
+    file. Reading and writing overlap the DSP, so the speed is bound by the
+    CPU, and the memory used does not depend on the length of the file.
+
+    Parameters can follow automation curves: the reader thread evaluates
+    them into a table of changes for each block, and the DSP splits the
+    block at the changes.
+
+    The output is compensated for the latency of the engine.
+
+    A segment of the output can be rendered on its own, for rendering a
+    file in parallel (see setSegment): the LFOs are advanced to the start
+    of the segment in closed form, and the filters are warmed up on the
+    input before it.
+
+    @tags{Offline}
+*/
+class StreamingFileProcessor
+{
+public:
+    //==============================================================================
+    /** Default number of samples in a block of the pipeline */
+    static const int defaultBlockSize = 16384;
+
+    /** Number of blocks in the ring of the pipeline */
+    static const int numBlocks = 4;
+
+    /** Number of blocks mapped at once from the input file */
+    static const int blocksPerMappedWindow = 16;
+
+    //==============================================================================
+    /** Constructor. The engine is prepared by each call to process */
+    explicit StreamingFileProcessor (HyperTremoloEngine&, int blockSize = defaultBlockSize);
+    ~StreamingFileProcessor();
+
+    //==============================================================================
+    /** Processes an audio file into a WAV file, with the same sample rate,
+        number of channels and bit depth. Returns false on failure
+        (see getLastError).
+
+        The output must not be the input file. It is written to a temporary
+        file, which replaces the output only when the render succeeds.
+    */
+    bool process (const juce::File& input, const juce::File& output);
+
+    /** Sets the automation of the next calls to process (nullptr for none).
+        The automation must outlive the calls.
+    */
+    void setAutomation (const AutomationLanes*) noexcept;
+
+    /** Makes the next calls to process render only a segment of the output,
+        from the start sample (included) to the end sample (excluded, -1 for
+        the end of the output). The samples are counted from the start of
+        the input, so the first ones of the output are the latency of the
+        effect.
+
+        The start must be a multiple of the block size, so that the engine
+        processes the same chunks as in a full render. The samples in the
+        pre-roll before the start are processed but not written.
+        Segments cannot be rendered with automation.
+    */
+    void setSegment (juce::int64 start, juce::int64 end, juce::int64 preRoll) noexcept;
+
+    /** Makes the next calls to process render the whole output */
+    void clearSegment() noexcept;
+
+    /** Gets the number of samples in a block of the pipeline */
+    int getBlockSize() const noexcept;
+
+    /** Stops the current call to process (from any thread) */
+    void cancel() noexcept;
+
+    /** Gets the progress of the current call to process, between 0 and 1
+        (from any thread)
+    */
+    float getProgress() const noexcept;
+
+    /** Gets the description of the last failure (after process has returned) */
+    const juce::String& getLastError() const noexcept;
+
+    /** Gets the length (in samples) of the last input file */
+    juce::int64 getInputLength() const noexcept;
+
+    /** Gets the sample rate of the last input file */
+    double getInputSampleRate() const noexcept;
+
+private:
+    //==============================================================================
+    /** A block of the ring */
+    struct Block
+    {
+        juce::AudioBuffer<float> buffer;
+        juce::int64 start = 0;
+        int numSamples = 0;
+
+        /** Parameter changes in the block, sorted by offset */
+        std::vector<AutomationPoint> automation;
+    };
+
+    /** A thread that runs one stage of the pipeline */
+    class StageThread;
+
+    //==============================================================================
+    std::unique_ptr<juce::AudioFormatReader> createReader (const juce::File&);
+    std::unique_ptr<juce::AudioFormatWriter> createWriter (const juce::File&, const juce::AudioFormatReader&);
+
+    void readBlocks (juce::AudioFormatReader&, juce::int64 numBlocksToRead);
+    void writeBlocks (juce::AudioFormatWriter&, juce::int64 numBlocksToWrite, juce::int64 writeStart);
+
+    /** Processes a block, splitting it at the parameter changes */
+    void processBlock (Block&) noexcept;
+
+    /** Waits until the counter is greater than the value, or until the
+        pipeline fails. Returns false if the pipeline failed.
+    */
+    bool waitFor (const std::atomic<juce::int64>& counter, juce::int64 value, juce::WaitableEvent&) const;
+
+    /** Makes the pipeline fail with the given message */
+    void fail (const juce::String&);
+
+    //==============================================================================
+    HyperTremoloEngine& engine;
+    const int blockSize;
+
+    juce::AudioFormatManager formatManager;
+    juce::MemoryMappedAudioFormatReader* mappedReader = nullptr;
+    const AutomationLanes* automation = nullptr;
+    std::unique_ptr<AutomationSchedule> schedule;
+    juce::int64 segmentStart = 0, segmentEnd = -1, preRoll = 0;
+    juce::int64 renderStart = 0, totalSamples = 0, inputLength = 0;
+    double inputSampleRate = 0.0;
+
+    std::array<Block, numBlocks> blocks;
+    std::atomic<juce::int64> numRead { 0 }, numProcessed { 0 }, numWritten { 0 };
+    juce::WaitableEvent readEvent, processedEvent, writtenEvent;
+
+    std::atomic<bool> failed { false };
+    std::atomic<float> progress { 0.0f };
+    juce::CriticalSection errorLock;
+    juce::String lastError;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StreamingFileProcessor)
+};
@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    BandAnalyzer.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "BandAnalyzer.h"
+
+//==============================================================================
+BandAnalyzer::BandAnalyzer()
+    : fifo (capacity),
+      fft (fftOrder),
+      window ((size_t) fftSize, juce::dsp::WindowingFunction<float>::hann)
+{
+    for (auto& h : history)
+        h.fill (0.0f);
+    for (auto& s : smoothed)
+        s.fill (0.0f);
+    for (auto& s : spectrum)
+        s.fill (0.0f);
+}
+
+void BandAnalyzer::prepare (double newSampleRate) noexcept
+{
+    sampleRate.store (newSampleRate, std::memory_order_relaxed);
+}
+
+void BandAnalyzer::setEnabled (bool f) noexcept
+{
+    enabled.store (f, std::memory_order_relaxed);
+}
+
+bool BandAnalyzer::isEnabled() const noexcept
+{
+    return enabled.load (std::memory_order_relaxed);
+}
+
+//==============================================================================
+void BandAnalyzer::pushBands (const float* lowPass, const float* highPass, size_t numSamples) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite ((int) numSamples, start1, size1, start2, size2);
+
+    const float* bands[numBands] = { lowPass, highPass };
+    for (size_t band = 0; band < (size_t) numBands; ++band)
+    {
+        std::copy (bands[band], bands[band] + size1, ring[band].begin() + start1);
+        std::copy (bands[band] + size1, bands[band] + size1 + size2, ring[band].begin() + start2);
+    }
+
+    fifo.finishedWrite (size1 + size2);
+}
+
+//==============================================================================
+void BandAnalyzer::appendToHistory (int band, const float* samples, int numSamples) noexcept
+{
+    auto& h = history[(size_t) band];
+
+    // Keep the last fftSize samples: shift the old ones to the left
+    if (numSamples >= fftSize)
+    {
+        std::copy (samples + numSamples - fftSize, samples + numSamples, h.begin());
+        return;
+    }
+    std::copy (h.begin() + numSamples, h.end(), h.begin());
+    std::copy (samples, samples + numSamples, h.end() - numSamples);
+}
+
+bool BandAnalyzer::analyze()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+    if (size1 + size2 == 0)
+        return false;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        appendToHistory (band, ring[(size_t) band].data() + start1, size1);
+        appendToHistory (band, ring[(size_t) band].data() + start2, size2);
+    }
+    fifo.finishedRead (size1 + size2);
+
+    // A full-scale sine peaks at fftSize / 4 with the Hann window
+    const auto binsPerHz = (float) fftSize / (float) sampleRate.load (std::memory_order_relaxed);
+    const auto fullScale = 4.0f / (float) fftSize;
+    const auto decay = 0.25f;
+
+    for (size_t band = 0; band < (size_t) numBands; ++band)
+    {
+        std::copy (history[band].begin(), history[band].end(), fftData.begin());
+        window.multiplyWithWindowingTable (fftData.data(), (size_t) fftSize);
+        fft.performFrequencyOnlyForwardTransform (fftData.data());
+
+        // Resample the magnitudes on a logarithmic frequency axis:
+        // fast attack, exponential decay
+        for (size_t i = 0; i < (size_t) numPoints; ++i)
+        {
+            const auto frequency = minFrequency * std::pow (maxFrequency / minFrequency, (float) i / (float) (numPoints - 1));
+            const auto bin = juce::jlimit (0, fftSize / 2, juce::roundToInt (frequency * binsPerHz));
+            const auto decibels = juce::Decibels::gainToDecibels (fftData[(size_t) bin] * fullScale, minDecibels);
+            const auto level = juce::jmap (decibels, minDecibels, 0.0f, 0.0f, 1.0f);
+
+            auto& s = smoothed[band][i];
+            s = level > s ? level : s + decay * (level - s);
+        }
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType sl (spectrumLock);
+        spectrum = smoothed;
+    }
+    hasNewSpectrum.store (true, std::memory_order_release);
+    return true;
+}
+
+bool BandAnalyzer::getSpectrum (float* lowPass, float* highPass)
+{
+    if (! hasNewSpectrum.exchange (false, std::memory_order_acquire))
+        return false;
+
+    const juce::SpinLock::ScopedLockType sl (spectrumLock);
+    std::copy (spectrum[0].begin(), spectrum[0].end(), lowPass);
+    std::copy (spectrum[1].begin(), spectrum[1].end(), highPass);
+    return true;
+}
+
+//==============================================================================
+BandAnalyzerThread::BandAnalyzerThread()
+    : juce::Thread ("HyperTremolo band analyzer")
+{
+    startThread();
+}
+
+BandAnalyzerThread::~BandAnalyzerThread()
+{
+    stopThread (1000);
+}
+
+void BandAnalyzerThread::addAnalyzer (BandAnalyzer* analyzer)
+{
+    const juce::ScopedLock sl (lock);
+    analyzers.addIfNotAlreadyThere (analyzer);
+}
+
+void BandAnalyzerThread::removeAnalyzer (BandAnalyzer* analyzer)
+{
+    const juce::ScopedLock sl (lock);
+    analyzers.removeFirstMatchingValue (analyzer);
+}
+
+void BandAnalyzerThread::run()
+{
+    while (! threadShouldExit())
+    {
+        {
+            const juce::ScopedLock sl (lock);
+            for (auto* analyzer : analyzers)
+                analyzer->analyze();
+        }
+        wait (1000 / refreshRateHz);
+    }
+}
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    BandAnalyzer.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../dsp/CrossoverWithBuffer.h"
+#include <JuceHeader.h>
+
+/**
+    Spectrum analyzer of the two crossover bands.
+
+    The audio thread copies the first channel of each band into a wait-free
+    single-producer single-consumer ring, only while the analyzer is enabled
+    (i.e. while an editor is showing it). The FFT and the smoothing run on
+    a BandAnalyzerThread, and the editor picks up the latest spectrum.
+*/
+class BandAnalyzer  : public CrossoverTap<float>
+{
+public:
+    //==============================================================================
+    static constexpr int fftOrder = 11, fftSize = 1 << fftOrder;
+    static constexpr int numBands = 2, numPoints = 128, capacity = 2 * fftSize;
+    static constexpr float minFrequency = 20.0f, maxFrequency = 20000.0f, minDecibels = -72.0f;
+
+    //==============================================================================
+    BandAnalyzer();
+
+    /** Sets the sample rate of the band signals */
+    void prepare (double sampleRate) noexcept;
+
+    /** Enables or disables the analyzer (consumer side) */
+    void setEnabled (bool) noexcept;
+
+    /** Checks whether bands should be pushed (producer side) */
+    bool isEnabled() const noexcept;
+
+    //==============================================================================
+    /** Pushes band samples (producer side). Samples are dropped when the ring is full */
+    void pushBands (const float* lowPass, const float* highPass, size_t numSamples) noexcept override;
+
+    /** Drains the ring and computes a new spectrum, if any sample arrived (worker side).
+        Returns true if a new spectrum was published.
+    */
+    bool analyze();
+
+    /** Copies the latest spectrum of each band, as numPoints values between 0 and 1
+        over a logarithmic frequency axis (editor side).
+        Returns false, without copying, if there is no new spectrum.
+    */
+    bool getSpectrum (float* lowPass, float* highPass);
+
+private:
+    //==============================================================================
+    void appendToHistory (int band, const float* samples, int numSamples) noexcept;
+
+    //==============================================================================
+    juce::AbstractFifo fifo;
+    std::array<std::array<float, capacity>, numBands> ring;
+    std::atomic<bool> enabled { false };
+    std::atomic<double> sampleRate { 44100.0 };
+
+    //==============================================================================
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    std::array<std::array<float, fftSize>, numBands> history;
+    std::array<float, 2 * fftSize> fftData;
+    std::array<std::array<float, numPoints>, numBands> smoothed;
+
+    //==============================================================================
+    juce::SpinLock spectrumLock;
+    std::array<std::array<float, numPoints>, numBands> spectrum;
+    std::atomic<bool> hasNewSpectrum { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandAnalyzer)
+};
+
+//==============================================================================
+/**
+    A background thread that runs the analysis of every open band analyzer.
+
+    It is meant to be held by a juce::SharedResourcePointer: all the
+    instances in the process share one thread, which exists only while at
+    least one editor is open. Each analyzer is served at most once per
+    period, so the cost is bounded by the refresh rate.
+*/
+class BandAnalyzerThread  : private juce::Thread
+{
+public:
+    //==============================================================================
+    BandAnalyzerThread();
+    ~BandAnalyzerThread() override;
+
+    /** Adds an analyzer to the ones served by the thread */
+    void addAnalyzer (BandAnalyzer*);
+
+    /** Removes an analyzer. When this returns, the thread no longer uses it */
+    void removeAnalyzer (BandAnalyzer*);
+
+private:
+    //==============================================================================
+    void run() override;
+
+    //==============================================================================
+    static const int refreshRateHz = 30;
+
+    juce::CriticalSection lock;
+    juce::Array<BandAnalyzer*> analyzers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandAnalyzerThread)
+};
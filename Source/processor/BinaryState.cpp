@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    BinaryState.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "BinaryState.h"
+
+namespace BinaryState
+{
+// "HTrB" as a little-endian integer
+static constexpr juce::uint32 magic = 0x42725448;
+
+juce::uint32 schemaHash (const juce::StringArray& parameterIDs, int numIDs)
+{
+    if (numIDs < 0)
+        numIDs = parameterIDs.size();
+
+    // FNV-1a hash of the IDs, each one terminated by a null character
+    juce::uint32 hash = 2166136261u;
+    for (int i = 0; i < numIDs; ++i)
+    {
+        for (auto* c = parameterIDs[i].toRawUTF8(); *c != 0; ++c)
+            hash = (hash ^ (juce::uint8) *c) * 16777619u;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool isBinaryState (const void* data, int sizeInBytes)
+{
+    return data != nullptr
+           && sizeInBytes >= (int) sizeof (juce::uint32)
+           && juce::ByteOrder::littleEndianInt (data) == magic;
+}
+
+void write (juce::MemoryBlock& destData,
+            juce::uint32 schema,
+            const std::vector<float>& values,
+            const std::vector<juce::MemoryBlock>& wavetables,
+            int program)
+{
+    auto size = 6 * sizeof (juce::uint32) + values.size() * sizeof (float);
+    for (auto& table : wavetables)
+        size += sizeof (juce::uint32) + table.getSize();
+
+    destData.ensureSize (size);
+
+    juce::MemoryOutputStream stream (destData, false);
+    stream.writeInt ((int) magic);
+    stream.writeInt ((int) version);
+    stream.writeInt ((int) schema);
+
+    stream.writeInt ((int) values.size());
+    for (auto v : values)
+        stream.writeFloat (v);
+
+    stream.writeInt ((int) wavetables.size());
+    for (auto& table : wavetables)
+    {
+        stream.writeInt ((int) table.getSize());
+        stream.write (table.getData(), table.getSize());
+    }
+
+    stream.writeInt (program);
+}
+
+bool read (const void* data,
+           int sizeInBytes,
+           const juce::StringArray& parameterIDs,
+           std::vector<float>& values,
+           std::vector<juce::MemoryBlock>& wavetables,
+           int& program)
+{
+    if (! isBinaryState (data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream stream (data, (size_t) sizeInBytes, false);
+    stream.readInt(); // magic
+
+    // Versions from the future cannot be read
+    const auto stateVersion = (juce::uint32) stream.readInt();
+    if (stateVersion > version)
+        return false;
+
+    // The schema is the one of the parameters that existed when the state
+    // was written, which are the first ones
+    const auto schema = (juce::uint32) stream.readInt();
+    const auto numValues = stream.readInt();
+    if (numValues < 0 || numValues > parameterIDs.size()
+        || schema != schemaHash (parameterIDs, numValues)
+        || stream.getNumBytesRemaining() < (juce::int64) numValues * (juce::int64) sizeof (float))
+        return false;
+
+    std::vector<float> newValues ((size_t) numValues);
+    for (auto& v : newValues)
+        v = stream.readFloat();
+
+    // Each table takes at least its size field: bound the count by the
+    // remaining data before allocating
+    const auto numTables = stream.readInt();
+    if (numTables < 0 || stream.getNumBytesRemaining() < (juce::int64) numTables * (juce::int64) sizeof (juce::uint32))
+        return false;
+
+    std::vector<juce::MemoryBlock> newTables ((size_t) numTables);
+    for (auto& table : newTables)
+    {
+        const auto tableSize = stream.readInt();
+        if (tableSize < 0 || stream.getNumBytesRemaining() < tableSize)
+            return false;
+
+        table.setSize ((size_t) tableSize);
+        stream.read (table.getData(), tableSize);
+    }
+
+    auto newProgram = -1;
+    if (stateVersion >= 6)
+    {
+        if (stream.getNumBytesRemaining() < (juce::int64) sizeof (juce::uint32))
+            return false;
+        newProgram = stream.readInt();
+    }
+
+    values.swap (newValues);
+    wavetables.swap (newTables);
+    program = newProgram;
+    return true;
+}
+} // namespace BinaryState
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    BinaryState.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    Compact binary format of the plugin state.
+
+    The state is a fixed layout of little-endian fields:
+    - the magic number and the format version
+    - the hash of the parameter schema (the parameter IDs, in order)
+    - the number of parameters and their (denormalised) values
+    - the number of user wavetables and, for each one, its size in bytes
+      followed by the raw table data
+    - the index of the current program (since version 6)
+
+    The values are only read back if the schema hash matches: when the
+    parameter set changes, the version must be increased and the previous
+    layouts migrated in read().
+
+    Version 2 appends the clock parameters to those of version 1, version 3
+    the envelope parameters, version 4 the sidechain parameters and version 5
+    the oversampling parameter. Version 6 appends the current program. New
+    parameters are only ever appended, so the state of a previous version
+    holds the values of a prefix of the current parameters, and its schema
+    is the hash of the IDs of that prefix.
+*/
+namespace BinaryState
+{
+/** Current version of the format */
+static constexpr juce::uint32 version = 6;
+
+/** Computes the schema hash of a list of parameter IDs,
+    or of its first numIDs ones
+*/
+juce::uint32 schemaHash (const juce::StringArray& parameterIDs, int numIDs = -1);
+
+/** Checks whether a block of data starts with the magic number
+    of the binary format (otherwise, it may be legacy XML state).
+*/
+bool isBinaryState (const void* data, int sizeInBytes);
+
+/** Writes the parameter values, the user wavetables and the current program to a block */
+void write (juce::MemoryBlock& destData,
+            juce::uint32 schema,
+            const std::vector<float>& values,
+            const std::vector<juce::MemoryBlock>& wavetables,
+            int program);
+
+/** Reads the parameter values, the user wavetables and the current program
+    from a block. Returns false if the data is not valid or its schema does
+    not match the parameter IDs, in which case the outputs are left untouched.
+
+    The state of a previous version has fewer values than parameter IDs:
+    the caller keeps the parameters after them at their default value.
+    Before version 6, the program is -1.
+*/
+bool read (const void* data,
+           int sizeInBytes,
+           const juce::StringArray& parameterIDs,
+           std::vector<float>& values,
+           std::vector<juce::MemoryBlock>& wavetables,
+           int& program);
+} // namespace BinaryState
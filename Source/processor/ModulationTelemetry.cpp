@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    ModulationTelemetry.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "ModulationTelemetry.h"
+
+//==============================================================================
+ModulationTelemetry::ModulationTelemetry()
+    : fifo (capacity)
+{
+}
+
+void ModulationTelemetry::setEnabled (bool f) noexcept
+{
+    enabled.store (f, std::memory_order_relaxed);
+}
+
+bool ModulationTelemetry::isEnabled() const noexcept
+{
+    return enabled.load (std::memory_order_relaxed);
+}
+
+//==============================================================================
+bool ModulationTelemetry::push (const Frame& frame) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+    if (size1 + size2 < 1)
+        return false;
+
+    frames[(size_t) (size1 > 0 ? start1 : start2)] = frame;
+    fifo.finishedWrite (1);
+    return true;
+}
+
+int ModulationTelemetry::pop (Frame* dest, int maxFrames) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (maxFrames, start1, size1, start2, size2);
+
+    std::copy (frames.begin() + start1, frames.begin() + start1 + size1, dest);
+    std::copy (frames.begin() + start2, frames.begin() + start2 + size2, dest + size1);
+
+    fifo.finishedRead (size1 + size2);
+    return size1 + size2;
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    ModulationTelemetry.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    A wait-free single-producer single-consumer feed of modulation frames,
+    from the audio thread to the editor.
+
+    The audio thread pushes one frame per processed chunk, only while the
+    feed is enabled (i.e. while an editor is showing it). Frames are dropped
+    when the FIFO is full, so pushing never blocks.
+*/
+class ModulationTelemetry
+{
+public:
+    //==============================================================================
+    /** A snapshot of the two tremolos */
+    struct Frame
+    {
+        /** Modulation value of the low-pass and high-pass band tremolos */
+        float modulation[2];
+
+        /** Peak level of the low-pass and high-pass bands */
+        float level[2];
+
+        /** Phase difference of the tremolos (in radians) */
+        float phaseDifference;
+    };
+
+    static constexpr int capacity = 1024;
+
+    //==============================================================================
+    ModulationTelemetry();
+
+    /** Enables or disables the feed (consumer side) */
+    void setEnabled (bool) noexcept;
+
+    /** Checks whether frames should be pushed (producer side) */
+    bool isEnabled() const noexcept;
+
+    //==============================================================================
+    /** Pushes a frame (producer side). Returns false if the frame was dropped */
+    bool push (const Frame&) noexcept;
+
+    /** Pops up to maxFrames frames (consumer side). Returns the number of frames */
+    int pop (Frame* dest, int maxFrames) noexcept;
+
+private:
+    //==============================================================================
+    juce::AbstractFifo fifo;
+    std::array<Frame, capacity> frames;
+    std::atomic<bool> enabled { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModulationTelemetry)
+};
@@ -27,6 +27,7 @@
 
 #pragma once
 
+#include "../dsp/ParameterSpec.h"
 #include <JuceHeader.h>
 
 template <typename ValueType>
@@ -45,55 +46,26 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LogRange<ValueType>)
 };
 
-/**
-    A simple listener for setting values from an AudioProcessorValueTreeState
+/** Creates the plugin parameter described by a parameter spec,
+    for an AudioProcessorValueTreeState
 */
-class SetterListener  : public juce::AudioProcessorValueTreeState::Listener
+template <typename Target>
+std::unique_ptr<juce::RangedAudioParameter> createParameter (const ParameterSpec<Target>& spec)
 {
-public:
-    SetterListener (std::function<void (float)>);
-    void parameterChanged (const juce::String&, float) override;
-
-private:
-    std::function<void (float)> setterFunction;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SetterListener)
-};
-
-/**
-    A listener for setting values of AM Frequency and Through-0
-*/
-class ThroughZeroAndFrequencySetterListener  : public juce::AudioProcessorValueTreeState::Listener
-{
-public:
-    ThroughZeroAndFrequencySetterListener (std::function<void (float)> frequencySetter, std::function<void (bool)> throughZeroSetter, std::function<std::atomic<float>*(juce::StringRef)> vtsGetter, juce::String freqID, juce::String tzeroID);
-    void parameterChanged (const juce::String&, float) override;
-
-private:
-    juce::String frequencyParameterID, throughZeroParameterID;
-    std::function<void (float)> frequencySetterFunction, throughZeroSetterFunction;
-    std::function<std::atomic<float>*(juce::StringRef)> valueTreeStateGetterFunction;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThroughZeroAndFrequencySetterListener)
-};
-
-/**
-    A listener for triggering the tremolo sync function
-*/
-class TremSyncSetterListener  : public juce::AudioProcessorValueTreeState::Listener
-{
-public:
-    TremSyncSetterListener (std::function<void()> sync);
-    void parameterChanged (const juce::String&, float) override;
-
-private:
-    std::function<juce::Value (juce::StringRef)> valueGetterFunction;
-    std::function<void()> sync;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TremSyncSetterListener)
-};
-
-
-/** Send a ValueChangedMessage to listeners for all params in the ValueTreeState
-*/
-void sendValueChangedMessageToAllListeners(juce::AudioProcessorValueTreeState&);
+    switch (spec.kind)
+    {
+        case ParameterSpec<Target>::logarithmic:
+            return std::make_unique<juce::AudioParameterFloat> (
+                spec.id, spec.name, LogRange<float> (spec.minimum, spec.maximum, spec.interval), spec.defaultValue, spec.label);
+        case ParameterSpec<Target>::choice:
+            return std::make_unique<juce::AudioParameterChoice> (
+                spec.id, spec.name, juce::StringArray::fromTokens (spec.choices, "|", ""), (int) spec.defaultValue);
+        case ParameterSpec<Target>::toggle:
+            return std::make_unique<juce::AudioParameterBool> (
+                spec.id, spec.name, spec.defaultValue != 0.0f);
+        case ParameterSpec<Target>::linear:
+        default:
+            return std::make_unique<juce::AudioParameterFloat> (
+                spec.id, spec.name, juce::NormalisableRange<float> (spec.minimum, spec.maximum, spec.interval, spec.skew), spec.defaultValue, spec.label);
+    }
+}
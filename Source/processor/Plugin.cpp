@@ -37,6 +37,7 @@ HyperTremoloPlugin::HyperTremoloPlugin()
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
               .withInput ("Input", juce::AudioChannelSet::stereo(), true)
+              .withInput ("Sidechain", juce::AudioChannelSet::stereo(), false)
 #endif
               .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
 #endif
@@ -44,20 +45,16 @@ HyperTremoloPlugin::HyperTremoloPlugin()
 #endif
       valueTreeState (*this, nullptr, "HyperTremolo", createParameterLayout())
 {
-    initializeListeners();
+    initializeParameters();
+    updateWavetables();
 }
 
 HyperTremoloPlugin::~HyperTremoloPlugin()
 {
-    auto n = listeners.size();
-    for (unsigned int i = 0; i < n; ++i)
-        if (listeners[i] != nullptr)
-        {
-            for (unsigned int j = i + 1; j < n; ++j)
-                if (listeners[i] == listeners[j])
-                    listeners[j] = nullptr;
-            delete listeners[i];
-        }
+    cancelPendingUpdate();
+
+    for (auto* p : parameters)
+        p->removeListener (this);
 }
 
 //==============================================================================
@@ -100,45 +97,117 @@ double HyperTremoloPlugin::getTailLengthSeconds() const
 
 int HyperTremoloPlugin::getNumPrograms()
 {
-    return 1;
+    const juce::SpinLock::ScopedLockType lock (programs->lock);
+    return programs->bank->getNumPrograms();
 }
 
 int HyperTremoloPlugin::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
+}
+
+void HyperTremoloPlugin::setCurrentProgram (int index)
+{
+    if (! juce::isPositiveAndBelow (index, getNumPrograms()))
+        return;
+
+    // The DSP is updated at the start of the next block,
+    // the parameters on the message thread
+    currentProgram = index;
+    pendingProgram = index;
+    programChanged = true;
+    triggerAsyncUpdate();
+}
+
+const juce::String HyperTremoloPlugin::getProgramName (int index)
+{
+    const juce::SpinLock::ScopedLockType lock (programs->lock);
+    return programs->bank->getName (index);
 }
 
-void HyperTremoloPlugin::setCurrentProgram (int)
+void HyperTremoloPlugin::changeProgramName (int index, const juce::String& newName)
 {
+    {
+        const juce::SpinLock::ScopedLockType lock (programs->lock);
+        programs->bank->renameProgram (index, newName);
+    }
+    programs->bank->saveUserPrograms (ProgramBank::getDefaultUserFile());
 }
 
-const juce::String HyperTremoloPlugin::getProgramName (int)
+void HyperTremoloPlugin::saveUserProgram (const juce::String& name)
 {
-    return {};
+    std::vector<float> values;
+    values.reserve (parameters.size());
+    for (auto* p : parameters)
+        values.push_back (p->convertFrom0to1 (p->getValue()));
+
+    {
+        const juce::SpinLock::ScopedLockType lock (programs->lock);
+        programs->bank->addUserProgram (name, values.data());
+        currentProgram = programs->bank->getNumPrograms() - 1;
+    }
+    programs->bank->saveUserPrograms (ProgramBank::getDefaultUserFile());
+    updateHostDisplay();
 }
 
-void HyperTremoloPlugin::changeProgramName (int, const juce::String&)
+bool HyperTremoloPlugin::applyProgram (int index) noexcept
 {
+    const juce::SpinLock::ScopedTryLockType lock (programs->lock);
+    if (! lock.isLocked())
+        return false;
+
+    // Gain, mixes, depth, morph, spread and crossover glide to the new
+    // values. The LFO rate and ratio step (the phase stays continuous),
+    // and so do the envelope settings, the choices and the toggles
+    const auto* values = programs->bank->getValues (index);
+    for (size_t i = 0; i < numParameters; ++i)
+        engine.storeParameterValue ((ParameterIndex) i, values[i]);
+    engine.applyParameterValues();
+    return true;
+}
+
+void HyperTremoloPlugin::handleAsyncUpdate()
+{
+    // The latency changes with the oversampling
+    const auto latency = engine.getLatencyInSamples();
+    if (reportedLatency.exchange (latency) != latency)
+        setLatencySamples (latency);
+
+    if (programChanged.exchange (false))
+    {
+        // The host is notified after the bank is released: the audio
+        // thread only tries the lock, and the host may call back into it
+        std::array<float, numParameters> values;
+        {
+            const juce::SpinLock::ScopedLockType lock (programs->lock);
+            const auto* programValues = programs->bank->getValues (currentProgram);
+            std::copy (programValues, programValues + numParameters, values.begin());
+        }
+        setParameterValues (values.data());
+    }
 }
 
 //==============================================================================
 void HyperTremoloPlugin::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+#if HYPERTREMOLO_PROFILE
+    prepareCounter.start();
+#endif
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = getMainBusNumOutputChannels();
 
-    gain.reset();
-    dryWet.reset();
-    processor.reset();
-
-    gain.prepare (spec);
-    dryWet.prepare (spec);
-    processor.prepare (spec);
-
-    // Enforce parameter value update
-    sendValueChangedMessageToAllListeners (valueTreeState);
+    // Enforce parameter value update: prepare applies the values
+    pushParameterValues();
+    engine.setChannelLayout (getChannelLayoutOfBus (false, 0));
+    engine.prepare (spec);
+    analyzer.prepare (sampleRate);
+    reportedLatency = engine.getLatencyInSamples();
+    setLatencySamples (reportedLatency);
+#if HYPERTREMOLO_PROFILE
+    prepareCounter.stop();
+#endif
 }
 
 void HyperTremoloPlugin::releaseResources()
@@ -152,18 +221,25 @@ bool HyperTremoloPlugin::isBusesLayoutSupported (const BusesLayout& layouts) con
     juce::ignoreUnused (layouts);
     return true;
 #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout is supported (mono, stereo, surround, ambisonic or discrete),
+    // the DSP processes groups of channels in parallel
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
         // This checks if the input layout matches the output layout
 #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // The sidechain is optional, mono or stereo
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto sidechain = layouts.getChannelSet (true, 1);
+        if (! sidechain.isDisabled()
+            && sidechain != juce::AudioChannelSet::mono()
+            && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
 #endif
 
     return true;
@@ -173,6 +249,9 @@ bool HyperTremoloPlugin::isBusesLayoutSupported (const BusesLayout& layouts) con
 
 void HyperTremoloPlugin::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
+#if HYPERTREMOLO_PROFILE
+    processCounter.start();
+#endif
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -180,18 +259,95 @@ void HyperTremoloPlugin::processBlock (juce::AudioBuffer<float>& buffer, juce::M
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    juce::dsp::AudioBlock<float> block (buffer);
+    // Switch program (retry on the next block if the bank is busy)
+    const auto program = pendingProgram.exchange (-1);
+    if (program >= 0 && ! applyProgram (program))
+    {
+        auto none = -1;
+        pendingProgram.compare_exchange_strong (none, program);
+    }
+
+    // Metering and analysis only cost while an editor shows them
+    auto& processor = engine.getProcessor();
+    const auto telemetryEnabled = telemetry.isEnabled();
+    processor.setTremoloMetering (telemetryEnabled);
+    processor.setCrossoverTap (analyzer.isEnabled() ? &analyzer : nullptr);
+
+    // The effect processes the main bus. The sidechain, when the host
+    // feeds one, only drives the envelope and the retrigger
+    auto block = juce::dsp::AudioBlock<float> (buffer).getSubsetChannelBlock (0, (size_t) getMainBusNumOutputChannels());
     juce::dsp::ProcessContextReplacing<float> context (block);
 
-    dryWet.pushDrySamples (context.getInputBlock());
-    processor.process (context);
-    gain.process (context);
-    dryWet.mixWetSamples (context.getOutputBlock());
+    if (getBusCount (true) > 1)
+        if (const auto numSidechainChannels = getChannelCountOfBus (true, 1))
+            engine.setSidechain (juce::dsp::AudioBlock<const float> (buffer.getArrayOfReadPointers() + getChannelIndexInProcessBlockBuffer (true, 1, 0),
+                                                                     (size_t) numSidechainChannels,
+                                                                     (size_t) buffer.getNumSamples()));
+
+    engine.process (context, [this, &processor, telemetryEnabled] {
+        if (telemetryEnabled)
+            telemetry.push ({ { processor.getTremoloModulation (0), processor.getTremoloModulation (1) },
+                              { processor.getTremoloLevel (0), processor.getTremoloLevel (1) },
+                              processor.getTremoloPhaseDifference() });
+    });
+
+    // The latency is reported to the host on the message thread
+    if (engine.getLatencyInSamples() != reportedLatency.load())
+        triggerAsyncUpdate();
+#if HYPERTREMOLO_PROFILE
+    processCounter.stop();
+#endif
 }
 
 void HyperTremoloPlugin::sync()
 {
-    processor.sync();
+    engine.getProcessor().sync();
+}
+
+ModulationTelemetry& HyperTremoloPlugin::getTelemetry() noexcept
+{
+    return telemetry;
+}
+
+BandAnalyzer& HyperTremoloPlugin::getAnalyzer() noexcept
+{
+    return analyzer;
+}
+
+//==============================================================================
+static juce::Identifier wavetableProperty (int index)
+{
+    return juce::String ("table") + juce::String (index);
+}
+
+void HyperTremoloPlugin::setUserWavetable (int index, const float* values, size_t size)
+{
+    jassert (juce::isPositiveAndBelow (index, numUserWavetables));
+    auto tables = valueTreeState.state.getOrCreateChildWithName ("WAVETABLES", nullptr);
+    tables.setProperty (wavetableProperty (index), juce::var (values, size * sizeof (float)), nullptr);
+    updateWavetables();
+}
+
+void HyperTremoloPlugin::updateWavetables()
+{
+    std::array<Wavetable<float>::Ptr, numUserWavetables> tables;
+    auto state = valueTreeState.state.getChildWithName ("WAVETABLES");
+    for (int i = 0; i < numUserWavetables; ++i)
+        if (auto* data = state.getProperty (wavetableProperty (i)).getBinaryData())
+            if (data->getSize() >= 2 * sizeof (float) && data->getSize() % sizeof (float) == 0)
+            {
+                const auto* samples = static_cast<const float*> (data->getData());
+                const auto numSamples = data->getSize() / sizeof (float);
+                if (std::all_of (samples, samples + numSamples, [] (float v) { return std::isfinite (v); }))
+                    tables[i] = Wavetable<float>::create (samples, numSamples);
+            }
+
+    // Fall back to the built-in shapes (also for tables with non-finite values)
+    if (tables[0] == nullptr)
+        tables[0] = Wavetable<float>::fromShape<WaveShapes::Sine<float>>();
+    if (tables[1] == nullptr)
+        tables[1] = Wavetable<float>::fromShape<WaveShapes::Sawtooth<float>>();
+    engine.getProcessor().setTremoloWavetables (tables[0], tables[1]);
 }
 
 //==============================================================================
@@ -208,105 +364,173 @@ juce::AudioProcessorEditor* HyperTremoloPlugin::createEditor()
 //==============================================================================
 void HyperTremoloPlugin::getStateInformation (juce::MemoryBlock& destData)
 {
-    std::unique_ptr<juce::XmlElement> xml (valueTreeState.copyState().createXml());
-    copyXmlToBinary (*xml, destData);
+    std::vector<float> values;
+    values.reserve (parameters.size());
+    for (auto* p : parameters)
+        values.push_back (p->convertFrom0to1 (p->getValue()));
+
+    std::vector<juce::MemoryBlock> wavetables (numUserWavetables);
+    auto state = valueTreeState.state.getChildWithName ("WAVETABLES");
+    for (int i = 0; i < numUserWavetables; ++i)
+        if (auto* data = state.getProperty (wavetableProperty (i)).getBinaryData())
+            wavetables[(size_t) i] = *data;
+
+    BinaryState::write (destData, parameterSchema, values, wavetables, currentProgram);
 }
 
 void HyperTremoloPlugin::setStateInformation (const void* data, int sizeInBytes)
 {
+    if (BinaryState::isBinaryState (data, sizeInBytes))
+    {
+        std::vector<float> values;
+        std::vector<juce::MemoryBlock> wavetables;
+        auto program = -1;
+        if (BinaryState::read (data, sizeInBytes, parameterIDs, values, wavetables, program))
+        {
+            // The parameters added since the state was saved are at their default
+            for (auto i = values.size(); i < parameters.size(); ++i)
+                values.push_back (parameters[i]->convertFrom0to1 (parameters[i]->getDefaultValue()));
+            applyState (values, wavetables);
+
+            // The values of the state are kept, even if the program changed since
+            if (juce::isPositiveAndBelow (program, getNumPrograms()))
+                currentProgram = program;
+        }
+        return;
+    }
+
+    // Legacy XML state
     std::unique_ptr<juce::XmlElement> xml (getXmlFromBinary (data, sizeInBytes));
     if (xml.get() != nullptr)
         if (xml->hasTagName (valueTreeState.state.getType()))
+        {
             valueTreeState.replaceState (juce::ValueTree::fromXml (*xml));
+            updateWavetables();
+        }
+}
+
+void HyperTremoloPlugin::applyState (const std::vector<float>& values, const std::vector<juce::MemoryBlock>& wavetables)
+{
+    jassert (values.size() == parameters.size());
+    if (values.size() != parameters.size())
+        return;
+
+    // The DSP is updated in one batch, after all the values are set
+    setParameterValues (values.data());
+
+    auto tables = valueTreeState.state.getOrCreateChildWithName ("WAVETABLES", nullptr);
+    for (int i = 0; i < numUserWavetables; ++i)
+        if (juce::isPositiveAndBelow (i, (int) wavetables.size()) && wavetables[(size_t) i].getSize() > 0)
+            tables.setProperty (wavetableProperty (i), juce::var (wavetables[(size_t) i]), nullptr);
+        else
+            tables.removeProperty (wavetableProperty (i), nullptr);
+
+    updateWavetables();
+    pushParameterValues();
 }
 
 //==============================================================================
 juce::AudioProcessorValueTreeState::ParameterLayout HyperTremoloPlugin::createParameterLayout()
 {
-    return {
-        std::make_unique<juce::AudioParameterFloat> (
-            "gain", "Gain", juce::NormalisableRange<float> (-20.0f, 20.0f, 0.01f), 0.0f, "dB"),
-        std::make_unique<juce::AudioParameterFloat> (
-            "mix", "Mix", juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f), 1.0f),
-        std::make_unique<juce::AudioParameterFloat> (
-            "tremRate", "Rate", juce::NormalisableRange<float> (0.0f, 20.0f, 0.001f, 0.333f), 2.5f, "Hz"),
-        std::make_unique<juce::AudioParameterFloat> (
-            "tremRatio", "Ratio", LogRange<float> (0.1f, 10.0f, 0.001f), 1.0f),
-        std::make_unique<juce::AudioParameterFloat> (
-            "tremMix", "Depth", juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f), 0.5f),
-        std::make_unique<juce::AudioParameterBool> (
-            "tremZero", "Through-0", false),
-        std::make_unique<juce::AudioParameterBool> (
-            "tremSync", "Sync", false),
-        std::make_unique<juce::AudioParameterFloat> (
-            "xoverFreq", "Crossover", LogRange<float> (50.0f, 20000.0f, 0.01f), 1000.0f, "Hz"),
-        std::make_unique<juce::AudioParameterFloat> (
-            "xoverReson", "Resonance", LogRange<float> (0.125f, 4.0f, 0.001f), 1.0f / juce::MathConstants<float>::sqrt2),
-        std::make_unique<juce::AudioParameterFloat> (
-            "xoverBalance", "Balance", juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f), 0.5f),
-        std::make_unique<juce::AudioParameterFloat> (
-            "xoverMix", "Harmonic", juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f), 1.0f)
-    };
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    for (auto& spec : HyperTremoloEngine::parameterTable)
+        layout.add (createParameter (spec));
+    return layout;
 }
 
-void HyperTremoloPlugin::initializeListeners()
+void HyperTremoloPlugin::setParameterValues (const float* values)
 {
-    jassert (listeners_ids.size() == 0);
-    jassert (listeners.size() == 0);
-
-    listeners_ids.push_back ("gain");
-    listeners.push_back (new SetterListener (std::bind (
-        &juce::dsp::Gain<float>::setGainDecibels, &gain, std::placeholders::_1)));
+    for (size_t i = 0; i < numParameters; ++i)
+    {
+        const auto value = parameters[i]->convertTo0to1 (values[i]);
+        settingValues[i].store (value);
+        parameters[i]->setValueNotifyingHost (value);
+        settingValues[i].store (-1.0f);
+    }
+}
 
-    listeners_ids.push_back ("mix");
-    listeners.push_back (new SetterListener (std::bind (
-        &juce::dsp::DryWetMixer<float>::setWetMixProportion, &dryWet, std::placeholders::_1)));
+void HyperTremoloPlugin::parameterValueChanged (int parameterIndex, float newValue)
+{
+    if (! juce::isPositiveAndBelow (parameterIndex, (int) numParameters))
+        return;
 
-    listeners_ids.push_back ("tremRate");
-    listeners_ids.push_back ("tremZero");
-    auto* t0AndF = new ThroughZeroAndFrequencySetterListener (
-        std::bind (
-            &DualTremolo<float>::setTremoloRate, &processor, std::placeholders::_1),
-        std::bind (
-            &DualTremolo<float>::setTremoloThroughZero, &processor, std::placeholders::_1),
-        std::bind (
-            &juce::AudioProcessorValueTreeState::getRawParameterValue, &valueTreeState, std::placeholders::_1),
-        "tremRate",
-        "tremZero");
-    listeners.push_back (t0AndF);
-    listeners.push_back (t0AndF);
+    // Only the notification of the value being set is skipped
+    // (once): any other value comes from somewhere else
+    const auto i = (size_t) parameterIndex;
+    auto expected = newValue;
+    if (settingValues[i].compare_exchange_strong (expected, -1.0f))
+        return;
 
-    listeners_ids.push_back ("tremSync");
-    listeners.push_back (new TremSyncSetterListener (std::bind (
-        &DualTremolo<float>::sync, &processor)));
+    engine.setParameterValue ((ParameterIndex) i, parameters[i]->convertFrom0to1 (newValue));
+}
 
-    listeners_ids.push_back ("tremRatio");
-    listeners.push_back (new SetterListener (std::bind (
-        &DualTremolo<float>::setTremoloRatio, &processor, std::placeholders::_1)));
+//==============================================================================
+void HyperTremoloPlugin::initializeParameters()
+{
+    for (size_t i = 0; i < numParameters; ++i)
+    {
+        settingValues[i].store (-1.0f);
+
+        const auto* id = HyperTremoloEngine::parameterTable[i].id;
+        parameters[i] = valueTreeState.getParameter (id);
+        rawParameterValues[i] = valueTreeState.getRawParameterValue (id);
+        engine.storeParameterValue ((ParameterIndex) i, *rawParameterValues[i]);
+
+        // The parameters are notified by index, which must match the table
+        jassert (parameters[i] != nullptr && parameters[i]->getParameterIndex() == (int) i);
+        parameters[i]->addListener (this);
+        parameterIDs.add (id);
+    }
+
+    parameterSchema = BinaryState::schemaHash (parameterIDs);
+}
 
-    listeners_ids.push_back ("tremMix");
-    listeners.push_back (new SetterListener (std::bind (
-        &DualTremolo<float>::setTremoloMix, &processor, std::placeholders::_1)));
+HyperTremoloPlugin::SharedPrograms::SharedPrograms()
+{
+    juce::StringArray parameterIDs;
+    std::vector<float> defaultValues;
+    for (auto& spec : HyperTremoloEngine::parameterTable)
+    {
+        parameterIDs.add (spec.id);
+        defaultValues.push_back (spec.defaultValue);
+    }
+
+    bank.reset (new ProgramBank (parameterIDs, defaultValues, [] (size_t i, float value) {
+        return HyperTremoloEngine::parameterTable[i].constrain (value);
+    }));
+
+    // Factory programs, as in the example settings of the manual:
+    // each one sets some parameters and leaves the others at their default
+    using Engine = HyperTremoloEngine;
+    struct Setting
+    {
+        ParameterIndex index;
+        float value;
+    };
 
-    listeners_ids.push_back ("xoverFreq");
-    listeners.push_back (new SetterListener (std::bind (
-        &DualTremolo<float>::setCrossoverFrequency, &processor, std::placeholders::_1)));
+    std::vector<float> values;
+    auto addFactoryProgram = [&] (const char* name, std::initializer_list<Setting> settings) {
+        values = defaultValues;
 
-    listeners_ids.push_back ("xoverReson");
-    listeners.push_back (new SetterListener (std::bind (
-        &DualTremolo<float>::setCrossoverResonance, &processor, std::placeholders::_1)));
+        for (auto& s : settings)
+            values[s.index] = s.value;
 
-    listeners_ids.push_back ("xoverBalance");
-    listeners.push_back (new SetterListener (std::bind (
-        &DualTremolo<float>::setCrossoverBalance, &processor, std::placeholders::_1)));
+        bank->addFactoryProgram (name, values.data());
+    };
 
-    listeners_ids.push_back ("xoverMix");
-    listeners.push_back (new SetterListener (std::bind (
-        &DualTremolo<float>::setCrossoverMix, &processor, std::placeholders::_1)));
+    addFactoryProgram ("Init", {});
+    addFactoryProgram ("Fast Pulsar", { { Engine::tremZeroParameter, 0.0f }, { Engine::tremRateParameter, 6.0f }, { Engine::tremRatioParameter, 1.0f }, { Engine::tremSyncParameter, 1.0f }, { Engine::tremMixParameter, 0.5f }, { Engine::xoverFreqParameter, 1000.0f }, { Engine::xoverResonParameter, 0.707f }, { Engine::xoverBalanceParameter, 0.5f }, { Engine::xoverMixParameter, 1.0f }, { Engine::gainParameter, 7.0f }, { Engine::mixParameter, 1.0f } });
+    addFactoryProgram ("Slow Phaser", { { Engine::tremZeroParameter, 0.0f }, { Engine::tremRateParameter, 0.75f }, { Engine::tremRatioParameter, 1.0f }, { Engine::tremSyncParameter, 1.0f }, { Engine::tremMixParameter, 0.67f }, { Engine::xoverFreqParameter, 1000.0f }, { Engine::xoverResonParameter, 0.707f }, { Engine::xoverBalanceParameter, 0.5f }, { Engine::xoverMixParameter, 1.0f }, { Engine::gainParameter, 7.0f }, { Engine::mixParameter, 1.0f } });
+    addFactoryProgram ("Subtle Rotary", { { Engine::tremZeroParameter, 0.0f }, { Engine::tremRateParameter, 1.33f }, { Engine::tremRatioParameter, 4.5f }, { Engine::tremSyncParameter, 0.0f }, { Engine::tremMixParameter, 0.9f }, { Engine::xoverFreqParameter, 1000.0f }, { Engine::xoverResonParameter, 0.707f }, { Engine::xoverBalanceParameter, 0.6f }, { Engine::xoverMixParameter, 1.0f }, { Engine::gainParameter, 7.0f }, { Engine::mixParameter, 1.0f } });
+    addFactoryProgram ("Rotary Cabinet", { { Engine::tremZeroParameter, 1.0f }, { Engine::tremRateParameter, 1.33f }, { Engine::tremRatioParameter, 4.5f }, { Engine::tremSyncParameter, 0.0f }, { Engine::tremMixParameter, 0.9f }, { Engine::xoverFreqParameter, 1000.0f }, { Engine::xoverResonParameter, 1.25f }, { Engine::xoverBalanceParameter, 0.6f }, { Engine::xoverMixParameter, 1.0f }, { Engine::gainParameter, 6.0f }, { Engine::mixParameter, 1.0f } });
+    addFactoryProgram ("Dual Trem", { { Engine::tremZeroParameter, 0.0f }, { Engine::tremRateParameter, 2.0f }, { Engine::tremRatioParameter, 4.0f }, { Engine::tremSyncParameter, 1.0f }, { Engine::tremMixParameter, 0.75f }, { Engine::xoverFreqParameter, 1000.0f }, { Engine::xoverResonParameter, 0.707f }, { Engine::xoverBalanceParameter, 0.5f }, { Engine::xoverMixParameter, 0.0f }, { Engine::gainParameter, 7.0f }, { Engine::mixParameter, 1.0f } });
+    addFactoryProgram ("Glitchy Resonances", { { Engine::tremZeroParameter, 0.0f }, { Engine::tremRateParameter, 6.28f }, { Engine::tremRatioParameter, 10.0f }, { Engine::tremSyncParameter, 0.0f }, { Engine::tremMixParameter, 1.0f }, { Engine::xoverFreqParameter, 200.0f }, { Engine::xoverResonParameter, 0.707f }, { Engine::xoverBalanceParameter, 0.333f }, { Engine::xoverMixParameter, 0.5f }, { Engine::gainParameter, 7.0f }, { Engine::mixParameter, 1.0f } });
 
-    jassert (listeners_ids.size() == listeners.size());
+    bank->loadUserPrograms (ProgramBank::getDefaultUserFile());
+}
 
-    auto n = listeners.size();
-    for (unsigned int i = 0; i < n; ++i)
-        valueTreeState.addParameterListener (listeners_ids[i], listeners[i]);
+void HyperTremoloPlugin::pushParameterValues()
+{
+    for (size_t i = 0; i < numParameters; ++i)
+        engine.setParameterValue ((ParameterIndex) i, rawParameterValues[i]->load());
 }
@@ -27,14 +27,21 @@
 
 #pragma once
 
-#include "../dsp/DualTremolo.h"
+#include "../Commons.h"
+#include "../dsp/HyperTremoloEngine.h"
+#include "BandAnalyzer.h"
+#include "BinaryState.h"
+#include "ModulationTelemetry.h"
+#include "ProgramBank.h"
 #include "Parameters.h"
 
 //==============================================================================
 /**
     AudioProcessor for the HyperTremolo plugin
 */
-class HyperTremoloPlugin  : public juce::AudioProcessor
+class HyperTremoloPlugin  : public juce::AudioProcessor,
+                            private juce::AudioProcessorParameter::Listener,
+                            private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -54,6 +61,26 @@ public:
     //==============================================================================
     void sync();
 
+    //==============================================================================
+    static const int numUserWavetables = 2;
+
+    /** Sets a user wavetable for the tremolo: one period of the LFO with
+        values between 0 and 1, at any resolution. The table is stored in
+        the plugin state.
+    */
+    void setUserWavetable (int index, const float* values, size_t size);
+
+    /** Adds the current parameter values to the bank as a user program,
+        and saves the user programs.
+    */
+    void saveUserProgram (const juce::String& name);
+
+    /** Gets the feed of the tremolo modulators, for the editor */
+    ModulationTelemetry& getTelemetry() noexcept;
+
+    /** Gets the spectrum analyzer of the crossover bands, for the editor */
+    BandAnalyzer& getAnalyzer() noexcept;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -78,19 +105,86 @@ public:
     void setStateInformation (const void* data, int sizeInBytes) override;
 
 private:
+    //==============================================================================
+    using ParameterIndex = HyperTremoloEngine::ParameterIndex;
+    static const size_t numParameters = HyperTremoloEngine::numParameters;
+
     //==============================================================================
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    void initializeListeners();
+    void initializeParameters();
+
+    /** Reads the value of each parameter and passes it to the engine,
+        which applies it on the next block (see HyperTremoloEngine::setParameterValue)
+    */
+    void pushParameterValues();
+    void updateWavetables();
+
+    /** Applies a whole state: the DSP is updated once, after
+        all the parameter values have been set.
+    */
+    void applyState (const std::vector<float>& values, const std::vector<juce::MemoryBlock>& wavetables);
+
+    /** Sets the values of all parameters, in the order of the schema,
+        without applying them to the DSP. Changes of other values that
+        arrive meanwhile (e.g. host automation) are still applied.
+    */
+    void setParameterValues (const float* values);
+
+    /** Applies the values of a program to the DSP. This is called on the audio
+        thread: it does not allocate and returns false if the bank is busy.
+    */
+    bool applyProgram (int index) noexcept;
+
+    /** Updates the parameters to the current program, and reports
+        the latency to the host (on the message thread)
+    */
+    void handleAsyncUpdate() override;
 
     //==============================================================================
-    juce::dsp::DryWetMixer<float> dryWet;
-    DualTremolo<float> processor;
-    juce::dsp::Gain<float> gain;
+    void parameterValueChanged (int parameterIndex, float newValue) override;
+    void parameterGestureChanged (int, bool) override {}
+
+    //==============================================================================
+    HyperTremoloEngine engine;
+    ModulationTelemetry telemetry;
+    BandAnalyzer analyzer;
+
+#if HYPERTREMOLO_PROFILE
+    juce::PerformanceCounter processCounter { HYPERTREMOLO_FAST_MATH ? "processBlock (fast math)" : "processBlock", 1000 };
+    juce::PerformanceCounter prepareCounter { "prepareToPlay", 10 };
+#endif
 
     //==============================================================================
     juce::AudioProcessorValueTreeState valueTreeState;
-    std::vector<juce::String> listeners_ids;
-    std::vector<juce::AudioProcessorValueTreeState::Listener*> listeners;
+    std::array<juce::RangedAudioParameter*, numParameters> parameters;
+    std::array<std::atomic<float>*, numParameters> rawParameterValues;
+    juce::StringArray parameterIDs;
+    juce::uint32 parameterSchema = 0;
+
+    /** The normalised value being set to each parameter by setParameterValues,
+        or a negative value: the notification of this value is not applied
+    */
+    std::array<std::atomic<float>, numParameters> settingValues;
+
+    //==============================================================================
+    /** The programs of all the instances of the process: the factory
+        programs and the user programs file are loaded once, and every
+        instance edits and saves the same bank
+    */
+    struct SharedPrograms
+    {
+        SharedPrograms();
+
+        std::unique_ptr<ProgramBank> bank;
+        juce::SpinLock lock;
+    };
+
+    juce::SharedResourcePointer<SharedPrograms> programs;
+    std::atomic<int> currentProgram { 0 }, pendingProgram { -1 };
+    std::atomic<bool> programChanged { false };
+
+    //==============================================================================
+    std::atomic<int> reportedLatency { 0 };
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HyperTremoloPlugin)
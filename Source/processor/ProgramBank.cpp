@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+    ProgramBank.cpp
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "ProgramBank.h"
+#include "BinaryState.h"
+
+// "HTrK" as a little-endian integer
+static constexpr juce::uint32 bankMagic = 0x4b725448;
+static constexpr juce::uint32 bankVersion = 1;
+
+//==============================================================================
+ProgramBank::ProgramBank (const juce::StringArray& ids,
+                          const std::vector<float>& defaults,
+                          ConstrainFunction constrainFunction)
+    : parameterIDs (ids),
+      defaultValues (defaults),
+      constrain (constrainFunction),
+      schema (BinaryState::schemaHash (ids)),
+      numParameters (defaults.size())
+{
+    jassert ((size_t) ids.size() == numParameters);
+    jassert (constrain != nullptr);
+}
+
+juce::File ProgramBank::getDefaultUserFile()
+{
+    return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+        .getChildFile ("HyperTremolo")
+        .getChildFile ("Programs.bin");
+}
+
+//==============================================================================
+void ProgramBank::addProgram (const juce::String& name, const float* newValues)
+{
+    names.add (name);
+    values.insert (values.end(), newValues, newValues + numParameters);
+}
+
+void ProgramBank::addFactoryProgram (const juce::String& name, const float* newValues)
+{
+    jassert (numFactoryPrograms == getNumPrograms());
+    addProgram (name, newValues);
+    ++numFactoryPrograms;
+}
+
+void ProgramBank::addUserProgram (const juce::String& name, const float* newValues)
+{
+    addProgram (name, newValues);
+}
+
+void ProgramBank::renameProgram (int index, const juce::String& name)
+{
+    if (index >= numFactoryPrograms && index < getNumPrograms())
+        names.set (index, name);
+}
+
+//==============================================================================
+int ProgramBank::getNumPrograms() const noexcept
+{
+    return names.size();
+}
+
+int ProgramBank::getNumFactoryPrograms() const noexcept
+{
+    return numFactoryPrograms;
+}
+
+juce::String ProgramBank::getName (int index) const
+{
+    return names[index];
+}
+
+const float* ProgramBank::getValues (int index) const noexcept
+{
+    jassert (juce::isPositiveAndBelow (index, getNumPrograms()));
+    return values.data() + (size_t) index * numParameters;
+}
+
+//==============================================================================
+bool ProgramBank::loadUserPrograms (const juce::File& file)
+{
+    juce::MemoryBlock data;
+    if (! file.loadFileAsData (data))
+        return false;
+
+    juce::MemoryInputStream stream (data, false);
+    if ((juce::uint32) stream.readInt() != bankMagic
+        || (juce::uint32) stream.readInt() > bankVersion)
+        return false;
+
+    // The file may have been saved with the first parameters only
+    const auto fileSchema = (juce::uint32) stream.readInt();
+    const auto numFileParameters = stream.readInt();
+    if (numFileParameters < 0 || (size_t) numFileParameters > numParameters
+        || fileSchema != BinaryState::schemaHash (parameterIDs, numFileParameters))
+        return false;
+
+    const auto numPrograms = stream.readInt();
+    const auto recordSize = maxNameLength + (size_t) numFileParameters * sizeof (float);
+    if (numPrograms < 0 || stream.getNumBytesRemaining() < (juce::int64) (recordSize * (size_t) numPrograms))
+        return false;
+
+    names.removeRange (numFactoryPrograms, names.size() - numFactoryPrograms);
+    values.resize ((size_t) numFactoryPrograms * numParameters);
+
+    auto record = defaultValues;
+    char name[maxNameLength + 1] = {};
+    for (int i = 0; i < numPrograms; ++i)
+    {
+        stream.read (name, (int) maxNameLength);
+
+        // The values reach the DSP: keep them in the ranges of the parameters
+        auto valid = true;
+        for (int p = 0; p < numFileParameters; ++p)
+        {
+            const auto value = stream.readFloat();
+            valid = valid && std::isfinite (value);
+            record[(size_t) p] = valid ? constrain ((size_t) p, value) : 0.0f;
+        }
+
+        if (valid)
+            addProgram (juce::String::fromUTF8 (name), record.data());
+    }
+    return true;
+}
+
+bool ProgramBank::saveUserPrograms (const juce::File& file) const
+{
+    juce::MemoryBlock data;
+    {
+        juce::MemoryOutputStream stream (data, false);
+        stream.writeInt ((int) bankMagic);
+        stream.writeInt ((int) bankVersion);
+        stream.writeInt ((int) schema);
+        stream.writeInt ((int) numParameters);
+        stream.writeInt (getNumPrograms() - numFactoryPrograms);
+
+        for (int i = numFactoryPrograms; i < getNumPrograms(); ++i)
+        {
+            // Truncated and null-padded name
+            char name[maxNameLength] = {};
+            names[i].copyToUTF8 (name, maxNameLength);
+            stream.write (name, maxNameLength);
+
+            const auto* v = getValues (i);
+            for (size_t p = 0; p < numParameters; ++p)
+                stream.writeFloat (v[p]);
+        }
+    }
+
+    return file.getParentDirectory().createDirectory()
+           && file.replaceWithData (data.getData(), data.getSize());
+}
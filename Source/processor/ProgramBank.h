@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    ProgramBank.h
+
+    Copyright (c) 2021 Marco Tiraboschi
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to
+    deal in the Software without restriction, including without limitation the
+    rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+    sell copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+    A bank of programs: named snapshots of the parameter values.
+
+    The snapshots are stored contiguously, in the order of the parameter
+    schema, so that getting the values of a program is O(1) and does not
+    allocate. The first programs are the factory programs, which are not
+    saved. The following ones are the user programs, which are saved in an
+    indexed binary file of fixed-size records:
+    - the magic number, the format version and the parameter schema hash
+    - the number of parameters and the number of programs
+    - for each program, its name (UTF-8, null-padded to maxNameLength
+      bytes) followed by the parameter values
+
+    As in BinaryState, parameters are only ever appended: a file saved with
+    fewer parameters is read if its schema matches the first parameter IDs,
+    and the parameters after them are set to their default value. The
+    values of a file are limited to the ranges of the parameters, and the
+    programs with non-finite values are dropped.
+
+    @see BinaryState
+*/
+class ProgramBank
+{
+public:
+    //==============================================================================
+    /** Limits the value of a parameter to its range (see ParameterSpec::constrain) */
+    using ConstrainFunction = float (*) (size_t parameter, float value);
+
+    ProgramBank (const juce::StringArray& parameterIDs,
+                 const std::vector<float>& defaultValues,
+                 ConstrainFunction constrain);
+
+    //==============================================================================
+    /** Maximum length of a program name in the bank file (in bytes) */
+    static constexpr size_t maxNameLength = 32;
+
+    /** Gets the default location of the user programs file */
+    static juce::File getDefaultUserFile();
+
+    //==============================================================================
+    /** Adds a factory program. Factory programs must be added before any user program */
+    void addFactoryProgram (const juce::String& name, const float* values);
+
+    /** Adds a user program */
+    void addUserProgram (const juce::String& name, const float* values);
+
+    /** Renames a user program. Factory programs can't be renamed */
+    void renameProgram (int index, const juce::String& name);
+
+    //==============================================================================
+    int getNumPrograms() const noexcept;
+    int getNumFactoryPrograms() const noexcept;
+    juce::String getName (int index) const;
+
+    /** Gets the parameter values of a program, in the order of the schema */
+    const float* getValues (int index) const noexcept;
+
+    //==============================================================================
+    /** Loads the user programs from a file, replacing the current ones.
+        Returns false if the file can't be read or its schema does not match.
+        The values are constrained, and the programs with non-finite values
+        are skipped.
+    */
+    bool loadUserPrograms (const juce::File&);
+
+    /** Saves the user programs to a file */
+    bool saveUserPrograms (const juce::File&) const;
+
+private:
+    //==============================================================================
+    void addProgram (const juce::String& name, const float* values);
+
+    //==============================================================================
+    juce::StringArray parameterIDs;
+    std::vector<float> defaultValues;
+    ConstrainFunction constrain;
+    juce::uint32 schema;
+    size_t numParameters;
+    int numFactoryPrograms = 0;
+    juce::StringArray names;
+    std::vector<float> values;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProgramBank)
+};